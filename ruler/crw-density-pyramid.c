@@ -0,0 +1,193 @@
+#include "crw-density-pyramid.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+/** The largest supported number of bits of the number of buckets in the finest level. */
+static const unsigned pyramid_max_leaf_bits = 24;
+
+struct _CrwDensityPyramid
+{
+    /** The value at the start of the first bucket. */
+    double lower_limit;
+    /** The size in the value range of a bucket of the finest level. */
+    double leaf_size;
+
+    /** The number of levels, the finest level having 2^(n_levels - 1) buckets. */
+    unsigned n_levels;
+    /** The buckets of all levels, starting with the finest level. */
+    CrwDensityBucket *buckets;
+    /** The index in \c buckets of the first bucket of each level. */
+    size_t *level_offsets;
+};
+
+/**
+ * Merges a bucket into another bucket.
+ * @param into The bucket to merge into.
+ * @param bucket The bucket to merge.
+ */
+static void crw_density_bucket_merge(CrwDensityBucket *into, const CrwDensityBucket *bucket)
+{
+    if (bucket->count == 0)
+    {
+        return;
+    }
+
+    if (into->count == 0)
+    {
+        *into = *bucket;
+        return;
+    }
+
+    into->min = fmin(into->min, bucket->min);
+    into->max = fmax(into->max, bucket->max);
+    into->count += bucket->count;
+}
+
+CrwDensityPyramid *crw_density_pyramid_new(const double *values, size_t n_values, unsigned leaf_bits)
+{
+    if (values == NULL || n_values == 0 || leaf_bits > pyramid_max_leaf_bits)
+    {
+        return NULL;
+    }
+
+    // The values may come from an arbitrary file, so the range they span must be finite
+    if (!isfinite(values[0]) || !isfinite(values[n_values - 1]))
+    {
+        return NULL;
+    }
+
+    CrwDensityPyramid *pyramid = calloc(1, sizeof(CrwDensityPyramid));
+    if (pyramid == NULL)
+    {
+        return NULL;
+    }
+
+    size_t n_leaves = (size_t) 1 << leaf_bits;
+    pyramid->n_levels = leaf_bits + 1;
+    pyramid->buckets = calloc(2 * n_leaves - 1, sizeof(CrwDensityBucket));
+    pyramid->level_offsets = calloc(pyramid->n_levels, sizeof(size_t));
+    if (pyramid->buckets == NULL || pyramid->level_offsets == NULL)
+    {
+        crw_density_pyramid_free(pyramid);
+        return NULL;
+    }
+
+    for (unsigned level = 1; level < pyramid->n_levels; level++)
+    {
+        pyramid->level_offsets[level] = pyramid->level_offsets[level - 1] + (n_leaves >> (level - 1));
+    }
+
+    // The values are sorted, so the range is known without looking at the values in between
+    double lower = values[0];
+    double upper = values[n_values - 1];
+    pyramid->lower_limit = lower;
+    // Divide before subtracting, so the size of the leaves does not overflow for extreme ranges
+    pyramid->leaf_size = upper > lower ? upper / n_leaves - lower / n_leaves : 1.0 / n_leaves;
+
+    // Stream over the values once, filling the finest level
+    double scale = 1 / pyramid->leaf_size;
+    for (size_t i = 0; i < n_values; i++)
+    {
+        double value = values[i];
+        if (isnan(value))
+        {
+            continue;
+        }
+
+        // Written so that an index of NaN is clamped as well, instead of being cast
+        double index = floor((value - lower) * scale);
+        size_t leaf = !(index > 0) ? 0 : index >= (double) n_leaves ? n_leaves - 1 : (size_t) index;
+
+        CrwDensityBucket *bucket = &pyramid->buckets[leaf];
+        if (bucket->count == 0)
+        {
+            bucket->min = value;
+            bucket->max = value;
+        }
+        else
+        {
+            bucket->min = fmin(bucket->min, value);
+            bucket->max = fmax(bucket->max, value);
+        }
+        bucket->count++;
+    }
+
+    // Build each coarser level by merging pairs of buckets of the previous level
+    for (unsigned level = 1; level < pyramid->n_levels; level++)
+    {
+        const CrwDensityBucket *finer = &pyramid->buckets[pyramid->level_offsets[level - 1]];
+        CrwDensityBucket *coarser = &pyramid->buckets[pyramid->level_offsets[level]];
+
+        for (size_t i = 0; i < n_leaves >> level; i++)
+        {
+            crw_density_bucket_merge(&coarser[i], &finer[2 * i]);
+            crw_density_bucket_merge(&coarser[i], &finer[2 * i + 1]);
+        }
+    }
+
+    return pyramid;
+}
+
+void crw_density_pyramid_free(CrwDensityPyramid *pyramid)
+{
+    if (pyramid == NULL)
+    {
+        return;
+    }
+
+    free(pyramid->buckets);
+    free(pyramid->level_offsets);
+    free(pyramid);
+}
+
+uint64_t crw_density_pyramid_get_count(const CrwDensityPyramid *pyramid)
+{
+    return pyramid->buckets[pyramid->level_offsets[pyramid->n_levels - 1]].count;
+}
+
+uint64_t crw_density_pyramid_sample(const CrwDensityPyramid *pyramid,
+                                    double lower_limit,
+                                    double upper_limit,
+                                    int n_pixels,
+                                    CrwDensityBucket *buckets)
+{
+    if (n_pixels <= 0 || !(upper_limit > lower_limit))
+    {
+        return 0;
+    }
+
+    // Select the finest level whose buckets are at least as large as a pixel,
+    // so every bucket in the range is read by at least one pixel
+    double pixel_size = (upper_limit - lower_limit) / n_pixels;
+    unsigned level = 0;
+    while (level + 1 < pyramid->n_levels && ldexp(pyramid->leaf_size, (int) level) < pixel_size)
+    {
+        level++;
+    }
+
+    const CrwDensityBucket *level_buckets = &pyramid->buckets[pyramid->level_offsets[level]];
+    size_t n_level_buckets = (size_t) 1 << (pyramid->n_levels - 1 - level);
+    double bucket_size = ldexp(pyramid->leaf_size, (int) level);
+
+    uint64_t max_count = 0;
+    for (int pixel = 0; pixel < n_pixels; pixel++)
+    {
+        // Read the bucket in the middle of the pixel
+        double value = lower_limit + (pixel + 0.5) * pixel_size;
+        double index = floor((value - pyramid->lower_limit) / bucket_size);
+
+        if (!(index >= 0 && index < (double) n_level_buckets))
+        {
+            buckets[pixel].count = 0;
+            continue;
+        }
+
+        buckets[pixel] = level_buckets[(size_t) index];
+        if (buckets[pixel].count > max_count)
+        {
+            max_count = buckets[pixel].count;
+        }
+    }
+    return max_count;
+}
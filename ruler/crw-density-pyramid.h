@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The aggregate of the values that fall in a bucket of a density pyramid.
+ */
+typedef struct
+{
+    /** The smallest value in the bucket. Undefined if \c count is 0. */
+    double min;
+    /** The largest value in the bucket. Undefined if \c count is 0. */
+    double max;
+    /** The number of values in the bucket. */
+    uint64_t count;
+} CrwDensityBucket;
+
+/**
+ * A min/max/count mipmap over the values of a sorted array.
+ *
+ * The finest level divides the range between the first and the last value in 2^leaf_bits buckets
+ * of equal size. Each following level merges pairs of buckets of the previous level, up to a
+ * single bucket covering all values. The values themselves are not retained.
+ */
+typedef struct _CrwDensityPyramid CrwDensityPyramid;
+
+/** The default number of bits of the number of buckets in the finest level of a pyramid. */
+#define CRW_DENSITY_PYRAMID_DEFAULT_LEAF_BITS 16
+
+/**
+ * Builds a density pyramid in a single streaming pass over an array of values.
+ * @param values The values in ascending order, which may be memory-mapped. The first and last value
+ *      must be finite, and values that are NaN are skipped.
+ * @param n_values The number of values. Must be larger than 0.
+ * @param leaf_bits The finest level of the pyramid will have 2^leaf_bits buckets. Must be at most 24.
+ * @return The new pyramid, or NULL if the arguments are invalid or the pyramid could not be allocated.
+ */
+CrwDensityPyramid *crw_density_pyramid_new(const double *values, size_t n_values, unsigned leaf_bits);
+
+/**
+ * Frees a density pyramid.
+ * @param pyramid The pyramid, may be NULL.
+ */
+void crw_density_pyramid_free(CrwDensityPyramid *pyramid);
+
+/**
+ * Returns the total number of values aggregated in a density pyramid.
+ * @param pyramid
+ */
+uint64_t crw_density_pyramid_get_count(const CrwDensityPyramid *pyramid);
+
+/**
+ * Samples a range of a density pyramid with one bucket per pixel.
+ *
+ * \remark Only the finest level whose buckets are at least as large as a pixel is read,
+ * so the cost depends on the number of pixels and not on the number of values.
+ * @param pyramid
+ * @param lower_limit The value at the start of the first pixel.
+ * @param upper_limit The value at the end of the last pixel. Must be greater than \p lower_limit.
+ * @param n_pixels The number of pixels to sample.
+ * @param buckets Return location for \p n_pixels buckets.
+ * @return The largest count of the sampled buckets.
+ */
+uint64_t crw_density_pyramid_sample(const CrwDensityPyramid *pyramid,
+                                    double lower_limit,
+                                    double upper_limit,
+                                    int n_pixels,
+                                    CrwDensityBucket *buckets);
+
+#ifdef __cplusplus
+}
+#endif
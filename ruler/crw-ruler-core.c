@@ -0,0 +1,879 @@
+#include "crw-ruler-core.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * The set of valid intervals between major ruler ticks is <br>
+ * { x * 10^n | x ∈ \c ruler_valid_intervals AND n : int AND n >= 0 } <br>
+ * \c ruler_valid_intervals is used when calculating an appropriate interval
+ * depending on the size of the ruler widget and the given range to display.
+ */
+static const int ruler_valid_intervals[] = {1, 5, 10, 25, 50, 100};
+
+/** The minimum amount of pixels between each minor tick. */
+static const int ruler_min_minor_tick_spacing = 5;
+
+/** The maximum depth of subdivisions of each segment between major ticks. */
+static const int ruler_max_tick_depth = 2;
+
+/** The number of ticks a layout has room for when it first allocates its tick storage. */
+static const size_t ruler_initial_ticks_capacity = 64;
+
+/** The default number of frames per second of a timecode scale. */
+static const int ruler_default_frame_rate = 25;
+
+#define NS_PER_SECOND INT64_C(1000000000)
+#define NS_PER_MINUTE (60 * NS_PER_SECOND)
+#define NS_PER_HOUR (60 * NS_PER_MINUTE)
+#define NS_PER_DAY (24 * NS_PER_HOUR)
+
+/** The average length of a month and a year in the Gregorian calendar, in days. */
+static const double ruler_days_per_month = 30.436875;
+static const double ruler_days_per_year = 365.2425;
+
+/**
+ * The steps between major ticks of a calendar scale with a fixed duration, in nanoseconds.
+ * All steps shorter than a day divide a day, so ticks restart at every midnight.
+ */
+static const int64_t ruler_calendar_fixed_steps[] = {
+        1, 2, 5, 10, 20, 50, 100, 200, 500,
+        1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000,
+        1000000, 2000000, 5000000, 10000000, 20000000, 50000000, 100000000, 200000000, 500000000,
+        NS_PER_SECOND, 2 * NS_PER_SECOND, 5 * NS_PER_SECOND, 10 * NS_PER_SECOND, 15 * NS_PER_SECOND, 30 * NS_PER_SECOND,
+        NS_PER_MINUTE, 2 * NS_PER_MINUTE, 5 * NS_PER_MINUTE, 10 * NS_PER_MINUTE, 15 * NS_PER_MINUTE, 30 * NS_PER_MINUTE,
+        NS_PER_HOUR, 2 * NS_PER_HOUR, 3 * NS_PER_HOUR, 6 * NS_PER_HOUR, 12 * NS_PER_HOUR,
+        NS_PER_DAY, 2 * NS_PER_DAY, 7 * NS_PER_DAY, 14 * NS_PER_DAY,
+};
+
+/** The steps between major ticks of a calendar scale in months, aligned to the start of the year. */
+static const int ruler_calendar_month_steps[] = {1, 2, 3, 6};
+
+/**
+ * The steps between major ticks of a timecode scale in seconds.
+ * Steps of less than a second are a number of frames.
+ */
+static const int ruler_timecode_second_steps[] = {
+        1, 2, 5, 10, 15, 30,
+        60, 2 * 60, 5 * 60, 10 * 60, 15 * 60, 30 * 60,
+        3600, 2 * 3600, 3 * 3600, 6 * 3600, 12 * 3600, 24 * 3600,
+};
+
+/**
+ * The steps between major ticks of a timecode scale of less than a second, in frames.
+ * Only the steps that divide the frame rate are used, so every second falls on a major tick.
+ */
+static const int ruler_timecode_frame_steps[] = {1, 2, 3, 4, 5, 6, 8, 10, 12, 15};
+
+/** The steps between major ticks of 1-2-5 sequences, used beyond the largest step of a table. */
+static const int ruler_decade_steps[] = {1, 2, 5};
+
+/** The magnitude of the limits of the int64_t range, which calendar positions in nanoseconds must stay within. */
+static const double ruler_int64_magnitude = 0x1p63;
+
+/**
+ * The maximum magnitude of the integer tick positions of the linear and timecode scales and of the
+ * interval between them, so that stepping a position by the interval or rounding it down to
+ * a multiple of the interval never overflows int64_t.
+ */
+static const double ruler_max_integer_magnitude = 0x1p62;
+
+
+// Forward declare any necessary functions
+
+static void crw_ruler_layout_select_timecode_step(CrwRulerLayout *layout);
+
+static bool crw_ruler_layout_place_timecode_ticks(CrwRulerLayout *layout);
+
+static void crw_ruler_layout_select_calendar_step(CrwRulerLayout *layout);
+
+static bool crw_ruler_layout_place_calendar_ticks(CrwRulerLayout *layout);
+
+
+void crw_ruler_layout_init(CrwRulerLayout *layout)
+{
+    layout->lower_limit = 0;
+    layout->upper_limit = 0;
+    layout->size = 0;
+    layout->min_major_tick_spacing = 0;
+    layout->scale = CRW_RULER_SCALE_LINEAR;
+    layout->frame_rate = ruler_default_frame_rate;
+
+    layout->interval = 0;
+    layout->step = 0;
+    layout->step_unit = CRW_RULER_STEP_NONE;
+    layout->ticks = NULL;
+    layout->n_ticks = 0;
+    layout->ticks_capacity = 0;
+}
+
+void crw_ruler_layout_clear(CrwRulerLayout *layout)
+{
+    free(layout->ticks);
+    crw_ruler_layout_init(layout);
+}
+
+/**
+ * Appends a tick to a layout.
+ * @param layout
+ * @param value The position of the tick in the ruler range.
+ * @param level The level of the tick, 0 for major ticks.
+ * @return The appended tick, or NULL if the tick storage could not be grown.
+ */
+static CrwRulerTick *crw_ruler_layout_append_tick(CrwRulerLayout *layout, double value, int level)
+{
+    if (layout->n_ticks == layout->ticks_capacity)
+    {
+        size_t capacity = layout->ticks_capacity > 0 ? 2 * layout->ticks_capacity : ruler_initial_ticks_capacity;
+        CrwRulerTick *ticks = realloc(layout->ticks, capacity * sizeof(CrwRulerTick));
+        if (ticks == NULL)
+        {
+            return NULL;
+        }
+
+        layout->ticks = ticks;
+        layout->ticks_capacity = capacity;
+    }
+
+    CrwRulerTick *tick = &layout->ticks[layout->n_ticks++];
+    tick->value = value;
+    tick->pos = crw_ruler_range_to_draw_pos(layout->lower_limit, layout->upper_limit, value, layout->size);
+    tick->level = level;
+    tick->label[0] = '\0';
+    return tick;
+}
+
+/**
+ * Appends the minor ticks for a given range to a layout.
+ * @param layout
+ * @param lower The lower limit of the range.
+ * @param upper The upper limit of the range.
+ * @param depth The depth of the recursion.
+ * @return False if the tick storage could not be grown.
+ */
+static bool crw_ruler_layout_subdivide(CrwRulerLayout *layout, double lower, double upper, int depth)
+{
+    if (depth > ruler_max_tick_depth - 1)
+    {
+        return true;
+    }
+
+    // Check that there is enough space between minor tick and edges of the limit when drawn
+    int lower_pos = crw_ruler_range_to_draw_pos(layout->lower_limit, layout->upper_limit, lower, layout->size);
+    int upper_pos = crw_ruler_range_to_draw_pos(layout->lower_limit, layout->upper_limit, upper, layout->size);
+    if (upper_pos - lower_pos < ruler_min_minor_tick_spacing)
+    {
+        return true;
+    }
+
+    // Add tick in middle of range
+    double tick_pos = lower + (upper - lower) / 2;
+    if (crw_ruler_layout_append_tick(layout, tick_pos, depth + 1) == NULL)
+    {
+        return false;
+    }
+
+    // Recursively add minor ticks between lower limit, tick position and upper limit
+    return crw_ruler_layout_subdivide(layout, lower, tick_pos, depth + 1)
+           && crw_ruler_layout_subdivide(layout, tick_pos, upper, depth + 1);
+}
+
+bool crw_ruler_layout_add_minor_ticks(CrwRulerLayout *layout, double lower, double upper)
+{
+    return crw_ruler_layout_subdivide(layout, lower, upper, 0);
+}
+
+/**
+ * Returns whether a number lies within a symmetric range. NaN never does.
+ * @param value
+ * @param magnitude The magnitude of the limits of the range. The upper limit is excluded.
+ */
+static bool crw_ruler_is_within(double value, double magnitude)
+{
+    return value >= -magnitude && value < magnitude;
+}
+
+void crw_ruler_layout_select_interval(CrwRulerLayout *layout)
+{
+    layout->interval = 0;
+    layout->step = 0;
+    layout->step_unit = CRW_RULER_STEP_NONE;
+
+    if (layout->size <= 0 || layout->upper_limit <= layout->lower_limit)
+    {
+        return;
+    }
+
+    switch (layout->scale)
+    {
+        case CRW_RULER_SCALE_TIMECODE:
+            crw_ruler_layout_select_timecode_step(layout);
+            break;
+
+        case CRW_RULER_SCALE_CALENDAR:
+            crw_ruler_layout_select_calendar_step(layout);
+            break;
+
+        default:
+            // Positions are converted to integers, which must fit in int64_t with room for an interval
+            if (crw_ruler_is_within(layout->lower_limit, ruler_max_integer_magnitude)
+                && crw_ruler_is_within(layout->upper_limit, ruler_max_integer_magnitude))
+            {
+                layout->interval = crw_ruler_calculate_interval(
+                        layout->size,
+                        layout->min_major_tick_spacing,
+                        layout->upper_limit - layout->lower_limit);
+            }
+            break;
+    }
+}
+
+bool crw_ruler_layout_place_ticks(CrwRulerLayout *layout)
+{
+    // Keep the allocated tick storage around for the next layout
+    layout->n_ticks = 0;
+
+    if (layout->size <= 0 || layout->upper_limit <= layout->lower_limit)
+    {
+        return true;
+    }
+
+    // Make sure the selected interval belongs to the current scale
+    bool is_time_scale = layout->scale == CRW_RULER_SCALE_TIMECODE || layout->scale == CRW_RULER_SCALE_CALENDAR;
+    bool has_time_step = layout->step > 0
+                         && (layout->step_unit == CRW_RULER_STEP_FRAMES) == (layout->scale == CRW_RULER_SCALE_TIMECODE);
+    if (is_time_scale ? !has_time_step : layout->interval <= 0)
+    {
+        crw_ruler_layout_select_interval(layout);
+    }
+
+    switch (layout->scale)
+    {
+        case CRW_RULER_SCALE_TIMECODE:
+            return crw_ruler_layout_place_timecode_ticks(layout);
+
+        case CRW_RULER_SCALE_CALENDAR:
+            return crw_ruler_layout_place_calendar_ticks(layout);
+
+        default:
+            break;
+    }
+
+    // No interval could be selected for a range beyond the largest integer position
+    if (layout->interval <= 0)
+    {
+        return true;
+    }
+
+    int64_t pos = crw_ruler_first_tick(layout->lower_limit, layout->interval);
+    // Move pos over the ruler range. There can never be more major ticks than pixels.
+    for (int n_major_ticks = 0; pos < layout->upper_limit && n_major_ticks <= layout->size; n_major_ticks++)
+    {
+        CrwRulerTick *tick = crw_ruler_layout_append_tick(layout, (double) pos, 0);
+        if (tick == NULL)
+        {
+            return false;
+        }
+        snprintf(tick->label, CRW_RULER_LABEL_SIZE, "%lld", (long long) pos);
+
+        // Add minor ticks between major ticks
+        if (!crw_ruler_layout_add_minor_ticks(layout, (double) pos, (double)(pos + layout->interval)))
+        {
+            return false;
+        }
+
+        pos += layout->interval;
+    }
+    return true;
+}
+
+bool crw_ruler_layout_compute(CrwRulerLayout *layout)
+{
+    crw_ruler_layout_select_interval(layout);
+    return crw_ruler_layout_place_ticks(layout);
+}
+
+// =======================
+// ===== TIME SCALES =====
+
+/**
+ * Returns the largest integer smaller than or equal to \p a / \p b.
+ * @param a
+ * @param b Must be larger than 0.
+ */
+static int64_t crw_ruler_floor_div(int64_t a, int64_t b)
+{
+    assert(b > 0);
+    int64_t quotient = a / b;
+    return (a % b != 0 && a < 0) ? quotient - 1 : quotient;
+}
+
+/**
+ * Returns the smallest step of a 1-2-5 sequence starting at \p base that is at least \p min_step.
+ * @param base The first step of the sequence.
+ * @param min_step The minimum size of the step.
+ */
+static double crw_ruler_decade_step(double base, double min_step)
+{
+    for (double magnitude = base; ; magnitude *= 10)
+    {
+        for (size_t i = 0; i < sizeof(ruler_decade_steps) / sizeof(ruler_decade_steps[0]); i++)
+        {
+            double step = ruler_decade_steps[i] * magnitude;
+            if (step >= min_step)
+            {
+                return step;
+            }
+        }
+    }
+}
+
+/**
+ * Returns the smallest size in the ruler range that major ticks must be apart.
+ * @param layout
+ */
+static double crw_ruler_layout_min_step(const CrwRulerLayout *layout)
+{
+    int min_spacing = layout->min_major_tick_spacing > 0 ? layout->min_major_tick_spacing : 1;
+    double max_num_segments = fmax(1, floor((double) layout->size / min_spacing));
+    return (layout->upper_limit - layout->lower_limit) / max_num_segments;
+}
+
+/**
+ * Returns the number of days in a month of the Gregorian calendar.
+ * @param year
+ * @param month The month, 1 for January.
+ */
+static int crw_ruler_days_in_month(int64_t year, int month)
+{
+    static const int days_in_month[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+    if (month == 2 && year % 4 == 0 && (year % 100 != 0 || year % 400 == 0))
+    {
+        return 29;
+    }
+    return days_in_month[month - 1];
+}
+
+/**
+ * Returns the number of days since the Unix epoch of a date in the Gregorian calendar.
+ * @param year
+ * @param month The month, 1 for January.
+ * @param day The day of the month, starting at 1.
+ */
+static int64_t crw_ruler_days_from_civil(int64_t year, int month, int day)
+{
+    // See http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+    year -= month <= 2;
+    int64_t era = crw_ruler_floor_div(year, 400);
+    int64_t year_of_era = year - era * 400;
+    int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+/**
+ * Converts a number of days since the Unix epoch to a date in the Gregorian calendar.
+ * @param days The number of days since the Unix epoch.
+ * @param year Return location for the year.
+ * @param month Return location for the month, 1 for January.
+ * @param day Return location for the day of the month, starting at 1.
+ */
+static void crw_ruler_civil_from_days(int64_t days, int64_t *year, int *month, int *day)
+{
+    // See http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+    days += 719468;
+    int64_t era = crw_ruler_floor_div(days, 146097);
+    int64_t day_of_era = days - era * 146097;
+    int64_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    int64_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    int64_t month_index = (5 * day_of_year + 2) / 153;
+
+    *day = (int)(day_of_year - (153 * month_index + 2) / 5 + 1);
+    *month = (int)(month_index < 10 ? month_index + 3 : month_index - 9);
+    *year = year_of_era + era * 400 + (*month <= 2);
+}
+
+/**
+ * A point in time on a calendar scale, split in calendar fields that are stepped incrementally.
+ */
+typedef struct
+{
+    /** The number of days since the Unix epoch. */
+    int64_t days;
+    /** The time of day in nanoseconds. */
+    int64_t time_of_day;
+
+    int64_t year;
+    int month;
+    int day;
+} CrwRulerCalendarTime;
+
+/**
+ * Moves a calendar time to the start of the next day.
+ * @param time
+ */
+static void crw_ruler_calendar_next_day(CrwRulerCalendarTime *time)
+{
+    time->days++;
+    time->day++;
+
+    if (time->day > crw_ruler_days_in_month(time->year, time->month))
+    {
+        time->day = 1;
+        time->month++;
+
+        if (time->month > 12)
+        {
+            time->month = 1;
+            time->year++;
+        }
+    }
+}
+
+/**
+ * Formats the label of a major tick of a calendar scale.
+ * @param label The buffer of size \c CRW_RULER_LABEL_SIZE to write the label to.
+ * @param time The time of the tick.
+ * @param unit The unit of the step between major ticks.
+ * @param step The step between major ticks.
+ */
+static void crw_ruler_calendar_label(char *label,
+                                     const CrwRulerCalendarTime *time,
+                                     CrwRulerStepUnit unit,
+                                     int64_t step)
+{
+    if (unit == CRW_RULER_STEP_YEARS)
+    {
+        snprintf(label, CRW_RULER_LABEL_SIZE, "%lld", (long long) time->year);
+        return;
+    }
+    if (unit == CRW_RULER_STEP_MONTHS)
+    {
+        snprintf(label, CRW_RULER_LABEL_SIZE, "%lld-%02d", (long long) time->year, time->month);
+        return;
+    }
+    if (step >= NS_PER_DAY || time->time_of_day == 0)
+    {
+        // Label the start of each day with its date
+        snprintf(label, CRW_RULER_LABEL_SIZE, "%lld-%02d-%02d", (long long) time->year, time->month, time->day);
+        return;
+    }
+
+    int hours = (int)(time->time_of_day / NS_PER_HOUR);
+    int minutes = (int)(time->time_of_day / NS_PER_MINUTE % 60);
+    int seconds = (int)(time->time_of_day / NS_PER_SECOND % 60);
+    int64_t fraction = time->time_of_day % NS_PER_SECOND;
+
+    if (step >= NS_PER_MINUTE)
+    {
+        snprintf(label, CRW_RULER_LABEL_SIZE, "%02d:%02d", hours, minutes);
+    }
+    else if (step >= NS_PER_SECOND)
+    {
+        snprintf(label, CRW_RULER_LABEL_SIZE, "%02d:%02d:%02d", hours, minutes, seconds);
+    }
+    else
+    {
+        // Show milliseconds, microseconds or nanoseconds depending on the step
+        int digits = step >= 1000000 ? 3 : step >= 1000 ? 6 : 9;
+        int64_t divisor = step >= 1000000 ? 1000000 : step >= 1000 ? 1000 : 1;
+        snprintf(label, CRW_RULER_LABEL_SIZE, "%02d:%02d:%02d.%0*lld",
+                 hours, minutes, seconds, digits, (long long)(fraction / divisor));
+    }
+}
+
+/**
+ * Selects the step between major ticks of a layout with a calendar scale.
+ * @param layout
+ */
+static void crw_ruler_layout_select_calendar_step(CrwRulerLayout *layout)
+{
+    // Positions are converted to whole nanoseconds and days, which must fit in int64_t
+    if (!crw_ruler_is_within(layout->lower_limit, ruler_int64_magnitude)
+        || !crw_ruler_is_within(layout->upper_limit, ruler_int64_magnitude))
+    {
+        return;
+    }
+
+    double min_step = crw_ruler_layout_min_step(layout);
+
+    // Far from the epoch, a double cannot represent every nanosecond, so never step
+    // by less than the spacing between representable values of the range
+    double max_magnitude = fmax(fabs(layout->lower_limit), fabs(layout->upper_limit));
+    min_step = fmax(min_step, nextafter(max_magnitude, INFINITY) - max_magnitude);
+
+    // Select the smallest step that keeps the major ticks far enough apart
+    size_t n_fixed_steps = sizeof(ruler_calendar_fixed_steps) / sizeof(ruler_calendar_fixed_steps[0]);
+    for (size_t i = 0; i < n_fixed_steps; i++)
+    {
+        if (ruler_calendar_fixed_steps[i] >= min_step)
+        {
+            layout->step_unit = CRW_RULER_STEP_NANOSECONDS;
+            layout->step = ruler_calendar_fixed_steps[i];
+            return;
+        }
+    }
+
+    size_t n_month_steps = sizeof(ruler_calendar_month_steps) / sizeof(ruler_calendar_month_steps[0]);
+    for (size_t i = 0; i < n_month_steps; i++)
+    {
+        if (ruler_calendar_month_steps[i] * ruler_days_per_month * NS_PER_DAY >= min_step)
+        {
+            layout->step_unit = CRW_RULER_STEP_MONTHS;
+            layout->step = ruler_calendar_month_steps[i];
+            return;
+        }
+    }
+
+    layout->step_unit = CRW_RULER_STEP_YEARS;
+    layout->step = (int64_t) crw_ruler_decade_step(1, min_step / (ruler_days_per_year * NS_PER_DAY));
+}
+
+/**
+ * Places the ticks of a layout with a calendar scale, using its selected step.
+ * @param layout
+ * @return False if the tick storage could not be allocated.
+ */
+static bool crw_ruler_layout_place_calendar_ticks(CrwRulerLayout *layout)
+{
+    CrwRulerStepUnit unit = layout->step_unit;
+    int64_t step = layout->step;
+
+    // No step could be selected for a range beyond the calendar
+    if (step <= 0)
+    {
+        return true;
+    }
+
+    // Convert only the first tick to calendar fields
+    CrwRulerCalendarTime time;
+    time.days = (int64_t) floor(layout->lower_limit / NS_PER_DAY);
+    time.time_of_day = 0;
+
+    if (unit == CRW_RULER_STEP_NANOSECONDS && step < NS_PER_DAY)
+    {
+        int64_t time_of_day = (int64_t)(layout->lower_limit - (double) time.days * NS_PER_DAY);
+        time_of_day = time_of_day < 0 ? 0 : time_of_day >= NS_PER_DAY ? NS_PER_DAY - 1 : time_of_day;
+        time.time_of_day = crw_ruler_floor_div(time_of_day, step) * step;
+    }
+    else if (unit == CRW_RULER_STEP_NANOSECONDS)
+    {
+        time.days = crw_ruler_floor_div(time.days, step / NS_PER_DAY) * (step / NS_PER_DAY);
+    }
+    crw_ruler_civil_from_days(time.days, &time.year, &time.month, &time.day);
+
+    if (unit == CRW_RULER_STEP_MONTHS)
+    {
+        time.month = (time.month - 1) / (int) step * (int) step + 1;
+        time.day = 1;
+        time.days = crw_ruler_days_from_civil(time.year, time.month, time.day);
+    }
+    else if (unit == CRW_RULER_STEP_YEARS)
+    {
+        time.year = crw_ruler_floor_div(time.year, step) * step;
+        time.month = 1;
+        time.day = 1;
+        time.days = crw_ruler_days_from_civil(time.year, time.month, time.day);
+    }
+
+    // There can never be more major ticks than pixels, which guards against a step
+    // that does not advance the tick due to the limited precision of the range
+    double value = (double) time.days * NS_PER_DAY + (double) time.time_of_day;
+    for (int n_major_ticks = 0; value < layout->upper_limit && n_major_ticks <= layout->size; n_major_ticks++)
+    {
+        CrwRulerTick *tick = crw_ruler_layout_append_tick(layout, value, 0);
+        if (tick == NULL)
+        {
+            return false;
+        }
+        crw_ruler_calendar_label(tick->label, &time, unit, step);
+
+        // Step the calendar fields to the next tick
+        if (unit == CRW_RULER_STEP_NANOSECONDS && step < NS_PER_DAY)
+        {
+            time.time_of_day += step;
+            if (time.time_of_day >= NS_PER_DAY)
+            {
+                time.time_of_day -= NS_PER_DAY;
+                crw_ruler_calendar_next_day(&time);
+            }
+        }
+        else if (unit == CRW_RULER_STEP_NANOSECONDS)
+        {
+            for (int64_t i = 0; i < step / NS_PER_DAY; i++)
+            {
+                crw_ruler_calendar_next_day(&time);
+            }
+        }
+        else if (unit == CRW_RULER_STEP_MONTHS)
+        {
+            for (int64_t i = 0; i < step; i++)
+            {
+                time.days += crw_ruler_days_in_month(time.year, time.month);
+                time.month++;
+                if (time.month > 12)
+                {
+                    time.month = 1;
+                    time.year++;
+                }
+            }
+        }
+        else
+        {
+            time.year += step;
+            time.days = crw_ruler_days_from_civil(time.year, time.month, time.day);
+        }
+
+        double next_value = (double) time.days * NS_PER_DAY + (double) time.time_of_day;
+
+        // Add minor ticks between major ticks
+        if (!crw_ruler_layout_add_minor_ticks(layout, value, next_value))
+        {
+            return false;
+        }
+
+        value = next_value;
+    }
+    return true;
+}
+
+/**
+ * A position on a timecode scale, split in timecode fields that are stepped incrementally.
+ * Negative positions are stored as the fields of their magnitude.
+ */
+typedef struct
+{
+    bool negative;
+    int64_t hours;
+    int minutes;
+    int seconds;
+    int frames;
+} CrwRulerTimecode;
+
+/**
+ * Splits a number of frames into timecode fields.
+ * @param timecode
+ * @param frames The number of frames.
+ * @param frame_rate The number of frames per second.
+ */
+static void crw_ruler_timecode_from_frames(CrwRulerTimecode *timecode, int64_t frames, int frame_rate)
+{
+    timecode->negative = frames < 0;
+    if (frames < 0)
+    {
+        frames = -frames;
+    }
+
+    timecode->frames = (int)(frames % frame_rate);
+    int64_t total_seconds = frames / frame_rate;
+    timecode->seconds = (int)(total_seconds % 60);
+    timecode->minutes = (int)(total_seconds / 60 % 60);
+    timecode->hours = total_seconds / 3600;
+}
+
+/**
+ * Adds a step to the magnitude of a timecode.
+ * @param timecode
+ * @param step The fields of the step.
+ * @param frame_rate The number of frames per second.
+ */
+static void crw_ruler_timecode_add(CrwRulerTimecode *timecode, const CrwRulerTimecode *step, int frame_rate)
+{
+    timecode->frames += step->frames;
+    timecode->seconds += step->seconds;
+    timecode->minutes += step->minutes;
+    timecode->hours += step->hours;
+
+    if (timecode->frames >= frame_rate)
+    {
+        timecode->frames -= frame_rate;
+        timecode->seconds++;
+    }
+    if (timecode->seconds >= 60)
+    {
+        timecode->seconds -= 60;
+        timecode->minutes++;
+    }
+    if (timecode->minutes >= 60)
+    {
+        timecode->minutes -= 60;
+        timecode->hours++;
+    }
+}
+
+/**
+ * Subtracts a step from the magnitude of a timecode. The magnitude must not become negative.
+ * @param timecode
+ * @param step The fields of the step.
+ * @param frame_rate The number of frames per second.
+ */
+static void crw_ruler_timecode_subtract(CrwRulerTimecode *timecode, const CrwRulerTimecode *step, int frame_rate)
+{
+    timecode->frames -= step->frames;
+    timecode->seconds -= step->seconds;
+    timecode->minutes -= step->minutes;
+    timecode->hours -= step->hours;
+
+    if (timecode->frames < 0)
+    {
+        timecode->frames += frame_rate;
+        timecode->seconds--;
+    }
+    if (timecode->seconds < 0)
+    {
+        timecode->seconds += 60;
+        timecode->minutes--;
+    }
+    if (timecode->minutes < 0)
+    {
+        timecode->minutes += 60;
+        timecode->hours--;
+    }
+}
+
+/**
+ * Selects the step between major ticks of a layout with a timecode scale.
+ * @param layout
+ */
+static void crw_ruler_layout_select_timecode_step(CrwRulerLayout *layout)
+{
+    int frame_rate = layout->frame_rate > 0 ? layout->frame_rate : ruler_default_frame_rate;
+
+    // Positions are converted to whole frames, which must fit in int64_t with room for a step
+    if (!crw_ruler_is_within(layout->lower_limit * frame_rate, ruler_max_integer_magnitude)
+        || !crw_ruler_is_within(layout->upper_limit * frame_rate, ruler_max_integer_magnitude))
+    {
+        return;
+    }
+
+    double min_step_frames = crw_ruler_layout_min_step(layout) * frame_rate;
+
+    // Select the smallest step that keeps the major ticks far enough apart
+    size_t n_frame_steps = sizeof(ruler_timecode_frame_steps) / sizeof(ruler_timecode_frame_steps[0]);
+    for (size_t i = 0; i < n_frame_steps; i++)
+    {
+        int step = ruler_timecode_frame_steps[i];
+        if (step < frame_rate && frame_rate % step == 0 && step >= min_step_frames)
+        {
+            layout->step_unit = CRW_RULER_STEP_FRAMES;
+            layout->step = step;
+            return;
+        }
+    }
+
+    size_t n_second_steps = sizeof(ruler_timecode_second_steps) / sizeof(ruler_timecode_second_steps[0]);
+    for (size_t i = 0; i < n_second_steps; i++)
+    {
+        if ((double) ruler_timecode_second_steps[i] * frame_rate >= min_step_frames)
+        {
+            layout->step_unit = CRW_RULER_STEP_FRAMES;
+            layout->step = (int64_t) ruler_timecode_second_steps[i] * frame_rate;
+            return;
+        }
+    }
+
+    // Beyond a day, step in whole days
+    double frames_per_day = 24.0 * 3600 * frame_rate;
+    double step = crw_ruler_decade_step(1, min_step_frames / frames_per_day) * frames_per_day;
+    if (step < ruler_max_integer_magnitude)
+    {
+        layout->step_unit = CRW_RULER_STEP_FRAMES;
+        layout->step = (int64_t) step;
+    }
+}
+
+/**
+ * Places the ticks of a layout with a timecode scale, using its selected step.
+ * @param layout
+ * @return False if the tick storage could not be allocated.
+ */
+static bool crw_ruler_layout_place_timecode_ticks(CrwRulerLayout *layout)
+{
+    int frame_rate = layout->frame_rate > 0 ? layout->frame_rate : ruler_default_frame_rate;
+    int64_t step = layout->step;
+
+    // No step could be selected for a range beyond the largest timecode
+    if (step <= 0)
+    {
+        return true;
+    }
+
+    CrwRulerTimecode step_fields;
+    crw_ruler_timecode_from_frames(&step_fields, step, frame_rate);
+
+    // Convert only the first tick to timecode fields
+    int64_t frame = crw_ruler_floor_div((int64_t) floor(layout->lower_limit * frame_rate), step) * step;
+    CrwRulerTimecode timecode;
+    crw_ruler_timecode_from_frames(&timecode, frame, frame_rate);
+
+    for (int n_major_ticks = 0; frame < layout->upper_limit * frame_rate && n_major_ticks <= layout->size; n_major_ticks++)
+    {
+        double value = (double) frame / frame_rate;
+
+        CrwRulerTick *tick = crw_ruler_layout_append_tick(layout, value, 0);
+        if (tick == NULL)
+        {
+            return false;
+        }
+        snprintf(tick->label, CRW_RULER_LABEL_SIZE, "%s%02lld:%02d:%02d:%02d",
+                 timecode.negative ? "-" : "",
+                 (long long) timecode.hours, timecode.minutes, timecode.seconds, timecode.frames);
+
+        // Step the timecode fields to the next tick, which never crosses zero
+        // because the ticks are multiples of the step
+        if (timecode.negative)
+        {
+            crw_ruler_timecode_subtract(&timecode, &step_fields, frame_rate);
+            timecode.negative = timecode.hours != 0 || timecode.minutes != 0
+                                || timecode.seconds != 0 || timecode.frames != 0;
+        }
+        else
+        {
+            crw_ruler_timecode_add(&timecode, &step_fields, frame_rate);
+        }
+        frame += step;
+
+        // Add minor ticks between major ticks
+        if (!crw_ruler_layout_add_minor_ticks(layout, value, (double) frame / frame_rate))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int64_t crw_ruler_calculate_interval(int ruler_width, int min_size_segment, double range_size)
+{
+    if (ruler_width <= 0 || min_size_segment <= 0 || !(range_size > 0) || !isfinite(range_size))
+    {
+        return 1;
+    }
+
+    double max_num_segments = fmax(1, floor((double)ruler_width/min_size_segment));
+    double smallest_interval = ceil(range_size / max_num_segments);
+    double interval_magnitude = fmax(0, ceil(log10(smallest_interval)) - 1);
+
+    // Compute the interval as a double, it is only converted once it is known to fit
+    double interval = 1;
+    int n_valid_intervals = sizeof(ruler_valid_intervals) / sizeof(ruler_valid_intervals[0]);
+    for (int i = 0; i < n_valid_intervals && interval < smallest_interval; i++)
+    {
+        interval = ruler_valid_intervals[i] * pow(10, interval_magnitude);
+    }
+    return interval < ruler_max_integer_magnitude ? (int64_t) interval : 0;
+}
+
+int64_t crw_ruler_first_tick(double range_lower, int64_t interval)
+{
+    return (int64_t)floor(range_lower / interval) * interval;
+}
+
+int crw_ruler_range_to_draw_pos(double lower_limit, double upper_limit, double pos, double allocated_size)
+{
+    double range_size = upper_limit - lower_limit;
+    double scale = allocated_size / range_size;
+    return (int)round(scale * (pos - lower_limit));
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The maximum length of a tick label, including the terminating null byte. */
+#define CRW_RULER_LABEL_SIZE 32
+
+/**
+ * The scales with which a ruler can label its range.
+ */
+typedef enum
+{
+    /** The range is a plain number, with integer intervals between major ticks. */
+    CRW_RULER_SCALE_LINEAR,
+    /**
+     * The range is expressed in seconds and labelled with SMPTE timecode (HH:MM:SS:FF).
+     * Major ticks fall on frames, seconds, minutes and hours.
+     * Ranges beyond 2^62 frames from zero have no ticks.
+     */
+    CRW_RULER_SCALE_TIMECODE,
+    /**
+     * The range is expressed in nanoseconds since the Unix epoch and labelled with UTC dates and times.
+     * Major ticks fall on fractions of seconds, seconds, minutes, hours, days, months and years.
+     * Steps are never smaller than the spacing between representable values of the range.
+     * Ranges beyond the nanoseconds representable by int64_t have no ticks.
+     */
+    CRW_RULER_SCALE_CALENDAR,
+} CrwRulerScale;
+
+/**
+ * The units of the step between major ticks of the time scales.
+ */
+typedef enum
+{
+    /** No step has been selected. */
+    CRW_RULER_STEP_NONE,
+    /** The step is a number of frames of a \c CRW_RULER_SCALE_TIMECODE scale. */
+    CRW_RULER_STEP_FRAMES,
+    /** The step is a fixed number of nanoseconds of a \c CRW_RULER_SCALE_CALENDAR scale. */
+    CRW_RULER_STEP_NANOSECONDS,
+    /** The step is a number of calendar months of a \c CRW_RULER_SCALE_CALENDAR scale. */
+    CRW_RULER_STEP_MONTHS,
+    /** The step is a number of calendar years of a \c CRW_RULER_SCALE_CALENDAR scale. */
+    CRW_RULER_STEP_YEARS,
+} CrwRulerStepUnit;
+
+/**
+ * A single tick of a computed ruler layout.
+ */
+typedef struct
+{
+    /** The position of the tick in the ruler range. */
+    double value;
+    /** The position of the tick in pixels along the ruler. */
+    int pos;
+    /** 0 for major ticks, the subdivision depth + 1 for minor ticks. */
+    int level;
+    /** The label of the tick. Empty for minor ticks. */
+    char label[CRW_RULER_LABEL_SIZE];
+} CrwRulerTick;
+
+/**
+ * The layout of a ruler: the interval, tick positions and labels for a range
+ * displayed on a ruler of a given size.
+ *
+ * \remark The layout does not depend on GTK. Layouts are independent of each other,
+ * so different layouts can be computed on different threads at the same time.
+ */
+typedef struct
+{
+    /* INPUTS */
+
+    /** The lower limit of the range to lay out. */
+    double lower_limit;
+    /** The upper limit of the range to lay out. Must be greater than \c lower_limit. */
+    double upper_limit;
+    /** The size of the ruler in pixels along its orientation. */
+    int size;
+    /** The minimum amount of pixels between each major tick. */
+    int min_major_tick_spacing;
+    /** The scale with which to label the range. */
+    CrwRulerScale scale;
+    /** The number of frames per second of a \c CRW_RULER_SCALE_TIMECODE scale. */
+    int frame_rate;
+
+    /* OUTPUTS */
+
+    /**
+     * The interval in the ruler range between major ticks. Only selected for \c CRW_RULER_SCALE_LINEAR,
+     * whose ranges beyond 2^62 from zero have no ticks.
+     */
+    int64_t interval;
+    /** The step between major ticks in \c step_unit. Only selected for the time scales. */
+    int64_t step;
+    /** The unit of \c step. */
+    CrwRulerStepUnit step_unit;
+    /** The computed ticks, in drawing order. */
+    CrwRulerTick *ticks;
+    /** The number of computed ticks. */
+    size_t n_ticks;
+    /** The number of ticks that fit in \c ticks without growing it. */
+    size_t ticks_capacity;
+} CrwRulerLayout;
+
+/**
+ * Initializes an empty layout.
+ * @param layout
+ */
+void crw_ruler_layout_init(CrwRulerLayout *layout);
+
+/**
+ * Frees the tick storage of a layout.
+ * @param layout
+ */
+void crw_ruler_layout_clear(CrwRulerLayout *layout);
+
+/**
+ * Selects the interval or step between major ticks of a layout from its inputs.
+ *
+ * \remark The interval only depends on the size of the range, the size of the ruler, the minimum
+ * spacing between major ticks, the scale and the frame rate. When only the position of the range
+ * changes, the ticks can be placed again with \c crw_ruler_layout_place_ticks() alone.
+ * @param layout
+ */
+void crw_ruler_layout_select_interval(CrwRulerLayout *layout);
+
+/**
+ * Places the ticks of a layout and formats their labels, using the previously selected interval.
+ *
+ * \remark If no interval has been selected for the scale of the layout, it is selected first.
+ * @param layout
+ * @return False if the tick storage could not be allocated.
+ */
+bool crw_ruler_layout_place_ticks(CrwRulerLayout *layout);
+
+/**
+ * Computes the interval, tick positions and labels of a layout from its inputs.
+ *
+ * \remark For the time scales, only the first major tick is converted from the range to
+ * a calendar date or timecode. All following ticks are found by stepping the fields of the
+ * previous tick, so the cost per tick does not depend on the zoom level.
+ *
+ * \remark The tick storage of the layout is reused, so computing a layout repeatedly
+ * only allocates when more ticks are needed than before.
+ * @param layout
+ * @return False if the tick storage could not be allocated.
+ */
+bool crw_ruler_layout_compute(CrwRulerLayout *layout);
+
+/**
+ * Appends the minor ticks between two major ticks to a layout, by recursively subdividing
+ * the range between them for as long as the ticks are far enough apart.
+ * @param layout
+ * @param lower The position of the lower major tick in the ruler range.
+ * @param upper The position of the upper major tick in the ruler range.
+ * @return False if the tick storage could not be allocated.
+ */
+bool crw_ruler_layout_add_minor_ticks(CrwRulerLayout *layout, double lower, double upper);
+
+/**
+ * Calculates the largest interval between major ruler ticks such that the pixel spacing between
+ * the major ticks is at least \p min_size_segment.
+ * \remark The calculation is generic for both vertical and horizontal rulers, but is framed as for
+ * a horizontal ruler.
+ * @param ruler_width The allocated width for the ruler. Must be larger than 0.
+ * @param min_size_segment The minimum space in pixels between major ruler ticks. Must be larger than 0.
+ * @param range_size The total size of the range. Must be larger than 0.
+ * @return An appropriate interval, 1 if any of the arguments is invalid,
+ * or 0 if the interval would not be smaller than 2^62.
+ */
+int64_t crw_ruler_calculate_interval(int ruler_width, int min_size_segment, double range_size);
+
+/**
+ * Returns a number x such that x is a multiple of \p interval and is smaller than \p range_lower.
+ * @param range_lower The lower limit of the range.
+ * @param interval The interval of the ruler.
+ * @return A number x such that x is a multiple of \p interval and is smaller than \p range_lower.
+ */
+int64_t crw_ruler_first_tick(double range_lower, int64_t interval);
+
+/**
+ * Converts a position in the ruler range to a position in pixels along the ruler.
+ * @param lower_limit The lower limit of the range.
+ * @param upper_limit The upper limit of the range.
+ * @param pos The position in the ruler range.
+ * @param allocated_size The size of the ruler in pixels along its orientation.
+ * @return The position in pixels.
+ */
+int crw_ruler_range_to_draw_pos(double lower_limit, double upper_limit, double pos, double allocated_size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,4 +1,8 @@
 #include "crw-ruler.h"
+#include "crw-ruler-core.h"
+#include "crw-density-pyramid.h"
+
+#include <math.h>
 
 /**
  * IDs for \c TEGRuler 's properties.
@@ -12,6 +16,9 @@ typedef enum {
     PROP_MAJOR_TICK_LENGTH,
     PROP_MIN_MAJOR_TICK_SPACING,
 
+    PROP_SCALE,
+    PROP_FRAME_RATE,
+
     // Being the element following the last property,
     // this will be equal to the number of properties
     N_PROPERTIES,
@@ -28,31 +35,135 @@ typedef enum {
 // which is initialized in the class_init function.
 static GParamSpec *props[N_PROPERTIES] = { NULL, };
 
+/**
+ * IDs for \c CrwRuler 's signals.
+ */
+typedef enum {
+    SIGNAL_LAYOUT_CHANGED,
+
+    N_SIGNALS,
+} CrwRulerSignal;
+
+static guint signals[N_SIGNALS] = { 0, };
+
 /** The name with which all ruler widgets can be referred to in CSS. */
 static const char* ruler_css_name = "ruler";
 
+/** The default minimum amount of pixels between each major tick. */
+static const int default_min_major_tick_spacing = 80;
+
+static const int ruler_default_height = 25;
+
+/** The default number of frames per second of a timecode scale. */
+static const int ruler_default_frame_rate = 25;
+
+/** The size in pixels of the density band across the ruler. */
+static const int ruler_density_band_size = 6;
+
+/** The font size in pixels used when the CSS font does not specify one. */
+static const double ruler_default_font_size = 11;
+/** The font family used when the CSS font does not specify one. */
+static const char *ruler_default_font_family = "sans-serif";
+
+/** The maximum length of the font family name passed to cairo, including the terminating null byte. */
+#define RULER_FONT_FAMILY_SIZE 64
+
 /**
- * The set of valid intervals between major ruler ticks is <br>
- * { x * 10^n | x ∈ \c ruler_valid_intervals AND n : int AND n >= 0 } <br>
- * \c ruler_valid_intervals is used when calculating an appropriate interval
- * depending on the size of the ruler widget and the given range to display.
+ * The parts of a ruler that are outdated and are resolved again before the ruler is drawn.
  */
-static const int ruler_valid_intervals[] = {1, 5, 10, 25, 50, 100};
+typedef enum
+{
+    /** The position of the range changed, so the ticks need to be placed again. */
+    RULER_DIRTY_RANGE = 1 << 0,
+    /** The interval between major ticks needs to be selected again, e.g. after the size of the range changed. */
+    RULER_DIRTY_INTERVAL = 1 << 1,
+    /** The length of the ticks or the density band changed, which only requires drawing again. */
+    RULER_DIRTY_GEOMETRY = 1 << 2,
+    /** The format of the labels changed, so the ticks need to be placed and labelled again. */
+    RULER_DIRTY_LABELS = 1 << 3,
+    /** The CSS of the ruler changed, so its style needs to be resolved again. */
+    RULER_DIRTY_STYLE = 1 << 4,
+    /** The size of the ruler along its orientation changed, which affects the interval and the ticks. */
+    RULER_DIRTY_ALLOCATION = 1 << 5,
+} CrwRulerDirty;
+
+/** The dirty bits that require the layout of a ruler to be computed again. */
+#define RULER_DIRTY_LAYOUT (RULER_DIRTY_RANGE | RULER_DIRTY_INTERVAL | RULER_DIRTY_LABELS | RULER_DIRTY_ALLOCATION)
+
+/** The dirty bits that require the interval between major ticks to be selected again. */
+#define RULER_DIRTY_SELECT_INTERVAL (RULER_DIRTY_INTERVAL | RULER_DIRTY_ALLOCATION)
+
+/** All dirty bits, with which a ruler starts out. */
+#define RULER_DIRTY_ALL (RULER_DIRTY_LAYOUT | RULER_DIRTY_GEOMETRY | RULER_DIRTY_STYLE)
 
-/** The default minimum amount of pixels between each major tick. */
-static const int default_min_major_tick_spacing = 80;
+/**
+ * A range published to a ruler from any thread.
+ */
+typedef struct
+{
+    double lower_limit;
+    double upper_limit;
+} CrwRulerRange;
 
-/** The minimum amount of pixels between each minor tick. */
-static const int ruler_min_minor_tick_spacing = 5;
+/**
+ * Memory fences that order the plain accesses to the published ranges with their sequence number.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define RULER_FENCE_ACQUIRE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define RULER_FENCE_RELEASE() __atomic_thread_fence(__ATOMIC_RELEASE)
+#else
+// The interlocked operations used by GLib on other compilers are full barriers
+static gint ruler_fence;
+#define RULER_FENCE_ACQUIRE() g_atomic_int_add(&ruler_fence, 0)
+#define RULER_FENCE_RELEASE() g_atomic_int_add(&ruler_fence, 0)
+#endif
 
-/** The maximum depth of subdivisions of each segment between major ticks. */
-static const int ruler_max_tick_depth = 2;
+/**
+ * The state with which ranges are published to a ruler from any thread.
+ * It is only allocated once the first range is published, as most rulers never publish a range.
+ */
+typedef struct
+{
+    /**
+     * The sequence number of the published range. It is odd while the publishing thread is writing
+     * a range, and \c ranges[(sequence >> 1) & 1] is the most recently published range.
+     * Only the publishing thread writes the sequence number.
+     */
+    gint sequence;
+    /** The double buffer of published ranges, guarded by \c sequence. */
+    CrwRulerRange ranges[2];
+    /** Whether the main loop has been woken up to apply the published range. */
+    gint wake_pending;
+    /** The source that wakes up the main loop when a range has been published. */
+    GSource *source;
+} CrwRulerPublication;
 
-static const int ruler_default_height = 25;
+/**
+ * An additional band of ticks stacked on the ticks of a ruler, sharing its range and allocation.
+ */
+typedef struct
+{
+    /** The scale with which the band labels the range. */
+    CrwRulerScale scale;
+    /** The size of a unit of the band in units of the range of the ruler. */
+    double unit;
+    /** The tick layout of the band, computed together with the layout of the ruler. */
+    CrwRulerLayout layout;
+} CrwRulerBand;
 
-// TODO Have not figured yet out how to read this information from (CSS) style context
-static const double FONT_SIZE = 11;
-static const char *FONT_FAMILY = "sans-serif";
+/**
+ * The style of a ruler as resolved from its CSS node.
+ */
+typedef struct
+{
+    /** The foreground color, used for the outline, ticks and labels. */
+    GdkRGBA color;
+    GtkBorder padding;
+    /** The font face created from the family, weight and slant of the CSS font. */
+    cairo_font_face_t *font_face;
+    /** The font size in pixels. */
+    double font_size;
+} CrwRulerStyle;
 
 /**
  * The instance struct containing the member variables of the ruler.
@@ -80,9 +191,62 @@ struct _CrwRuler
     double upper_limit;
 
     /**
-     * The interval in the ruler range to draw with.
+     * The parts of the ruler that are outdated, as a combination of \c CrwRulerDirty bits.
+     */
+    guint dirty : 6;
+    /** Whether the ruler is queued in the batch of the shared layout worker pool. */
+    guint layout_pending : 1;
+    /** Whether the layout has been computed again since \c CrwRuler::layout-changed was last emitted. */
+    guint layout_changed : 1;
+    /** Whether the emission of \c CrwRuler::layout-changed has been deferred to the next frame. */
+    guint layout_changed_deferred : 1;
+    /**
+     * Whether the interval of the prepared layouts is selected again when they are computed,
+     * copied from the dirty bits because the layouts may be computed on a worker thread.
+     */
+    guint layout_select_interval : 1;
+
+    /**
+     * The tick layout of the ruler, recomputed when any of the \c RULER_DIRTY_LAYOUT bits is set.
+     */
+    CrwRulerLayout layout;
+    /** The \c CrwRulerBand s stacked on the ticks of the ruler, or NULL if the ruler has a single band. */
+    GArray *bands;
+
+    /**
+     * The cached style of the ruler, resolved again after the CSS of the ruler has changed.
+     */
+    CrwRulerStyle style;
+
+    /**
+     * The aggregated density of events along the range, or NULL if the ruler shows no density band.
+     */
+    CrwDensityPyramid *density;
+    /** The buckets sampled from \c density for each pixel, reused between frames. */
+    CrwDensityBucket *density_samples;
+    int n_density_samples;
+
+    /* RENDERING */
+
+    /**
+     * The render node with the last drawn contents of the ruler, appended again while the contents
+     * do not change, or NULL. Released when the ruler is unmapped.
      */
-    int interval;
+    GskRenderNode *node;
+
+    /* THREAD-SAFE RANGE PUBLICATION */
+
+    /** The state of ranges published from any thread, or NULL until the first range is published. */
+    CrwRulerPublication *publication;
+    /** The handler of the update phase of the frame clock, in which the published range is applied. */
+    gulong frame_clock_update_handler;
+
+    /* LAYOUT NOTIFICATION */
+
+    /** The handler of the layout phase of the frame clock, in which \c CrwRuler::layout-changed is emitted. */
+    gulong frame_clock_layout_handler;
+    /** The frame counter of the frame in which \c CrwRuler::layout-changed was last emitted. */
+    gint64 layout_changed_frame;
 
     /* DRAWING PROPERTIES */
 
@@ -93,21 +257,31 @@ struct _CrwRuler
     /** The minimum amount of pixels between each major tick. */
     int min_major_tick_spacing;
 
+    /** The scale with which the range is labelled. */
+    CrwRulerScale scale;
+
+    /** The number of frames per second of a timecode scale. */
+    int frame_rate;
+
     /**
-     * The orientation of the ruler.
+     * The orientation of the ruler, on which the drawing functions branch.
      */
     GtkOrientation orientation;
+};
 
-    // The ruler uses a strategy-like pattern with these pointers to functions
-    // that implement the drawing of the different elements of the ruler
-    // which depend on the orientation of the ruler
+/** Whether layouts are computed in batches by the shared worker pool. */
+static bool ruler_parallel_layout = false;
 
-    void (* draw_outline) (CrwRuler *self, cairo_t *cr);
+/** The worker pool shared by all rulers for computing their layouts. */
+static GThreadPool *ruler_layout_pool = NULL;
 
-    void (* draw_tick) (CrwRuler *self, cairo_t *cr, double pos, double tick_length_percent, bool draw_label, const char* label);
+/** The rulers whose layout has been invalidated and will be computed in the next batch. */
+static GPtrArray *ruler_pending_layouts = NULL;
 
-    int (* pixel_spacing) (CrwRuler *self, double lower_limit, double upper_limit);
-};
+/** The number of layouts of the current batch that have not been computed yet. */
+static guint ruler_batch_remaining = 0;
+static GMutex ruler_batch_mutex;
+static GCond ruler_batch_cond;
 
 // Define the type CrwRuler, which extends GtkWidget and implements GtkOrientable
 G_DEFINE_TYPE_WITH_CODE(CrwRuler, crw_ruler, GTK_TYPE_WIDGET,
@@ -116,13 +290,23 @@ G_DEFINE_TYPE_WITH_CODE(CrwRuler, crw_ruler, GTK_TYPE_WIDGET,
 
 // Forward declare any necessary functions
 
-static int crw_ruler_calculate_interval(int ruler_width, int min_size_segment, double range_size);
+static void crw_ruler_invalidate(CrwRuler *self, guint dirty);
+
+static void crw_ruler_frame_clock_update(GdkFrameClock *frame_clock, gpointer user_data);
+
+static void crw_ruler_request_layout_changed(CrwRuler *self);
 
-static void crw_ruler_switch_draw_strategy(CrwRuler *self, GtkOrientation orientation);
+static void crw_ruler_layout_changed(CrwRuler *self);
 
-static int crw_ruler_first_tick(double range_lower, int interval);
+static void crw_ruler_prepare_band_layout(CrwRuler *self,
+                                          CrwRulerLayout *layout,
+                                          CrwRulerScale scale,
+                                          double unit,
+                                          int size);
 
-static void crw_ruler_update_interval(CrwRuler *self);
+static void crw_ruler_place_ticks(CrwRulerLayout *layout);
+
+static void crw_ruler_resolve_style(CrwRuler *self);
 
 
 // ======================================
@@ -130,12 +314,25 @@ static void crw_ruler_update_interval(CrwRuler *self);
 
 void crw_ruler_set_range(CrwRuler *self, double lower_limit, double upper_limit)
 {
+    g_return_if_fail(isfinite(lower_limit) && isfinite(upper_limit));
     g_return_if_fail(lower_limit < upper_limit);
 
+    if (self->lower_limit == lower_limit && self->upper_limit == upper_limit)
+    {
+        return;
+    }
+
+    // Panning keeps the interval between major ticks, only zooming changes it
+    guint dirty = RULER_DIRTY_RANGE;
+    if (upper_limit - lower_limit != self->upper_limit - self->lower_limit)
+    {
+        dirty |= RULER_DIRTY_INTERVAL;
+    }
+
     self->lower_limit = lower_limit;
     self->upper_limit = upper_limit;
 
-    crw_ruler_update_interval(self);
+    crw_ruler_invalidate(self, dirty);
 }
 
 double crw_ruler_get_lower_limit(CrwRuler *self)
@@ -148,6 +345,166 @@ double crw_ruler_get_upper_limit(CrwRuler *self)
     return self->upper_limit;
 }
 
+/**
+ * Reads the most recently published range of a ruler.
+ * @param self
+ * @param range Return location for the published range.
+ */
+static void crw_ruler_read_published_range(CrwRuler *self, CrwRulerRange *range)
+{
+    CrwRulerPublication *publication = g_atomic_pointer_get(&self->publication);
+    guint sequence;
+    guint sequence_after;
+
+    do
+    {
+        sequence = (guint) g_atomic_int_get(&publication->sequence);
+        *range = publication->ranges[(sequence >> 1) & 1];
+
+        // Keep the reads of the range from being reordered after the second read of the sequence
+        RULER_FENCE_ACQUIRE();
+        sequence_after = (guint) g_atomic_int_get(&publication->sequence);
+
+        // The slot that was read is only overwritten by the publication after the one
+        // that was in progress or completed when reading started
+    } while (sequence_after - sequence > ((sequence & 1) ? 1u : 2u));
+}
+
+/**
+ * Applies the most recently published range to a ruler. Must be called on the main thread.
+ * @param self
+ */
+static void crw_ruler_apply_published_range(CrwRuler *self)
+{
+    CrwRulerPublication *publication = g_atomic_pointer_get(&self->publication);
+    if (publication == NULL)
+    {
+        return;
+    }
+
+    // Let the next publication wake up the main loop again before reading,
+    // so that no publication can be missed
+    g_atomic_int_set(&publication->wake_pending, 0);
+
+    CrwRulerRange range;
+    crw_ruler_read_published_range(self, &range);
+
+    if (range.lower_limit < range.upper_limit
+        && (range.lower_limit != self->lower_limit || range.upper_limit != self->upper_limit))
+    {
+        crw_ruler_set_range(self, range.lower_limit, range.upper_limit);
+    }
+}
+
+/**
+ * Called on the main thread after a range has been published from any thread.
+ * @param user_data The ruler.
+ * @return \c G_SOURCE_CONTINUE
+ */
+static gboolean crw_ruler_published_range_wake(gpointer user_data)
+{
+    CrwRuler *self = CRW_RULER(user_data);
+
+    GdkFrameClock *frame_clock = gtk_widget_get_frame_clock(GTK_WIDGET(self));
+    if (frame_clock != NULL)
+    {
+        // Only rulers to which a range is published follow the update phase of the frame clock
+        if (self->frame_clock_update_handler == 0)
+        {
+            self->frame_clock_update_handler = g_signal_connect(frame_clock,
+                                                                "update",
+                                                                G_CALLBACK(crw_ruler_frame_clock_update),
+                                                                self);
+        }
+
+        // Apply the range in the update phase of the next frame
+        gdk_frame_clock_request_phase(frame_clock, GDK_FRAME_CLOCK_PHASE_UPDATE);
+    }
+    else
+    {
+        crw_ruler_apply_published_range(self);
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean crw_ruler_published_source_dispatch(GSource *source, GSourceFunc callback, gpointer user_data)
+{
+    // Sleep until the next range is published
+    g_source_set_ready_time(source, -1);
+    return callback(user_data);
+}
+
+static GSourceFuncs crw_ruler_published_source_funcs = {
+        .dispatch = crw_ruler_published_source_dispatch,
+};
+
+static void crw_ruler_frame_clock_update(GdkFrameClock *frame_clock, gpointer user_data)
+{
+    crw_ruler_apply_published_range(CRW_RULER(user_data));
+}
+
+/**
+ * Returns the publication state of a ruler, creating it if no range has been published yet.
+ * \remark Called from the single thread that publishes ranges to the ruler, which may be any thread.
+ * The state is only created by that thread and is stored atomically, so the main thread either sees
+ * no state or a fully initialized one.
+ * @param self
+ * @return The publication state.
+ */
+static CrwRulerPublication *crw_ruler_ensure_publication(CrwRuler *self)
+{
+    CrwRulerPublication *publication = g_atomic_pointer_get(&self->publication);
+    if (publication != NULL)
+    {
+        return publication;
+    }
+
+    publication = g_new0(CrwRulerPublication, 1);
+    publication->source = g_source_new(&crw_ruler_published_source_funcs, sizeof(GSource));
+    g_source_set_callback(publication->source, crw_ruler_published_range_wake, self, NULL);
+    g_source_set_priority(publication->source, G_PRIORITY_DEFAULT);
+
+    g_atomic_pointer_set(&self->publication, publication);
+
+    g_source_attach(publication->source, NULL);
+    return publication;
+}
+
+void crw_ruler_publish_range_threadsafe(CrwRuler *self, double lower_limit, double upper_limit)
+{
+    g_return_if_fail(isfinite(lower_limit) && isfinite(upper_limit));
+    g_return_if_fail(lower_limit < upper_limit);
+
+    CrwRulerPublication *publication = crw_ruler_ensure_publication(self);
+
+    // There is a single publishing thread, so the sequence is even and the current slot
+    // can be read without retrying
+    gint sequence = g_atomic_int_get(&publication->sequence);
+
+    const CrwRulerRange *current = &publication->ranges[(sequence >> 1) & 1];
+    if (current->lower_limit == lower_limit && current->upper_limit == upper_limit)
+    {
+        return;
+    }
+
+    // Make the sequence odd before the other slot is written, so that a reader still reading
+    // that slot from an earlier publication notices that it has to retry
+    g_atomic_int_set(&publication->sequence, sequence + 1);
+    RULER_FENCE_RELEASE();
+
+    // Write to the other slot, so that readers of the current slot never have to retry
+    CrwRulerRange *next = &publication->ranges[((sequence >> 1) + 1) & 1];
+    next->lower_limit = lower_limit;
+    next->upper_limit = upper_limit;
+    g_atomic_int_set(&publication->sequence, sequence + 2);
+
+    // Only wake up the main loop once until the published range has been applied
+    if (g_atomic_int_compare_and_exchange(&publication->wake_pending, 0, 1))
+    {
+        g_source_set_ready_time(publication->source, 0);
+    }
+}
+
 void crw_ruler_set_desired_width(CrwRuler *self, int width)
 {
     g_return_if_fail(width >= 0);
@@ -197,7 +554,7 @@ static bool crw_ruler_set_orientation(CrwRuler *self, GtkOrientation orientation
     if (gtk_orientable_get_orientation(GTK_ORIENTABLE(self)) != orientation)
     {
         self->orientation = orientation;
-        crw_ruler_switch_draw_strategy(self, self->orientation);
+        crw_ruler_invalidate(self, RULER_DIRTY_ALLOCATION | RULER_DIRTY_GEOMETRY);
 
         return true;
     }
@@ -216,18 +573,212 @@ static int crw_ruler_get_orientation(CrwRuler *self)
 
 void crw_ruler_set_major_tick_length(CrwRuler *self, double length_percent)
 {
+    if (self->major_tick_length_percent == length_percent)
+    {
+        return;
+    }
+
     self->major_tick_length_percent = length_percent;
+    crw_ruler_invalidate(self, RULER_DIRTY_GEOMETRY);
 
     g_object_notify_by_pspec (G_OBJECT (self), props[PROP_MAJOR_TICK_LENGTH]);
 }
 
 void crw_ruler_set_min_major_tick_spacing(CrwRuler *self, int min_spacing)
 {
+    if (self->min_major_tick_spacing == min_spacing)
+    {
+        return;
+    }
+
     self->min_major_tick_spacing = min_spacing;
+    crw_ruler_invalidate(self, RULER_DIRTY_INTERVAL);
 
     g_object_notify_by_pspec (G_OBJECT (self), props[PROP_MIN_MAJOR_TICK_SPACING]);
 }
 
+GType crw_ruler_scale_get_type(void)
+{
+    static gsize scale_type = 0;
+
+    if (g_once_init_enter(&scale_type))
+    {
+        static const GEnumValue values[] = {
+                { CRW_RULER_SCALE_LINEAR, "CRW_RULER_SCALE_LINEAR", "linear" },
+                { CRW_RULER_SCALE_TIMECODE, "CRW_RULER_SCALE_TIMECODE", "timecode" },
+                { CRW_RULER_SCALE_CALENDAR, "CRW_RULER_SCALE_CALENDAR", "calendar" },
+                { 0, NULL, NULL },
+        };
+        g_once_init_leave(&scale_type, g_enum_register_static("CrwRulerScale", values));
+    }
+    return scale_type;
+}
+
+void crw_ruler_set_scale(CrwRuler *self, CrwRulerScale scale)
+{
+    if (self->scale == scale)
+    {
+        return;
+    }
+
+    self->scale = scale;
+    crw_ruler_invalidate(self, RULER_DIRTY_INTERVAL | RULER_DIRTY_LABELS);
+    g_object_notify_by_pspec (G_OBJECT (self), props[PROP_SCALE]);
+}
+
+CrwRulerScale crw_ruler_get_scale(CrwRuler *self)
+{
+    return self->scale;
+}
+
+void crw_ruler_set_frame_rate(CrwRuler *self, int frame_rate)
+{
+    g_return_if_fail(frame_rate > 0);
+
+    if (self->frame_rate == frame_rate)
+    {
+        return;
+    }
+
+    self->frame_rate = frame_rate;
+    crw_ruler_invalidate(self, RULER_DIRTY_INTERVAL | RULER_DIRTY_LABELS);
+    g_object_notify_by_pspec (G_OBJECT (self), props[PROP_FRAME_RATE]);
+}
+
+int crw_ruler_get_frame_rate(CrwRuler *self)
+{
+    return self->frame_rate;
+}
+
+void crw_ruler_get_config(CrwRuler *self, CrwRulerConfig *config)
+{
+    config->lower_limit = self->lower_limit;
+    config->upper_limit = self->upper_limit;
+    config->major_tick_length = self->major_tick_length_percent;
+    config->min_major_tick_spacing = self->min_major_tick_spacing;
+    config->scale = self->scale;
+    config->frame_rate = self->frame_rate;
+}
+
+void crw_ruler_rebind(CrwRuler *self, const CrwRulerConfig *config)
+{
+    g_return_if_fail(config != NULL);
+    g_return_if_fail(isfinite(config->lower_limit) && isfinite(config->upper_limit));
+    g_return_if_fail(config->lower_limit < config->upper_limit);
+    g_return_if_fail(config->major_tick_length >= 0.1 && config->major_tick_length <= 1);
+    g_return_if_fail(config->min_major_tick_spacing > 0);
+    g_return_if_fail(config->frame_rate > 0);
+
+    GObject *object = G_OBJECT(self);
+    guint dirty = 0;
+
+    // Collect the dirty bits of all changed values, so they are invalidated only once
+    g_object_freeze_notify(object);
+
+    if (config->lower_limit != self->lower_limit || config->upper_limit != self->upper_limit)
+    {
+        dirty |= RULER_DIRTY_RANGE;
+        if (config->upper_limit - config->lower_limit != self->upper_limit - self->lower_limit)
+        {
+            dirty |= RULER_DIRTY_INTERVAL;
+        }
+
+        self->lower_limit = config->lower_limit;
+        self->upper_limit = config->upper_limit;
+    }
+
+    if (config->major_tick_length != self->major_tick_length_percent)
+    {
+        self->major_tick_length_percent = config->major_tick_length;
+        dirty |= RULER_DIRTY_GEOMETRY;
+        g_object_notify_by_pspec(object, props[PROP_MAJOR_TICK_LENGTH]);
+    }
+
+    if (config->min_major_tick_spacing != self->min_major_tick_spacing)
+    {
+        self->min_major_tick_spacing = config->min_major_tick_spacing;
+        dirty |= RULER_DIRTY_INTERVAL;
+        g_object_notify_by_pspec(object, props[PROP_MIN_MAJOR_TICK_SPACING]);
+    }
+
+    if (config->scale != self->scale)
+    {
+        self->scale = config->scale;
+        dirty |= RULER_DIRTY_INTERVAL | RULER_DIRTY_LABELS;
+        g_object_notify_by_pspec(object, props[PROP_SCALE]);
+    }
+
+    if (config->frame_rate != self->frame_rate)
+    {
+        self->frame_rate = config->frame_rate;
+        dirty |= RULER_DIRTY_INTERVAL | RULER_DIRTY_LABELS;
+        g_object_notify_by_pspec(object, props[PROP_FRAME_RATE]);
+    }
+
+    if (dirty != 0)
+    {
+        crw_ruler_invalidate(self, dirty);
+    }
+
+    g_object_thaw_notify(object);
+}
+
+static void crw_ruler_band_clear(gpointer data)
+{
+    CrwRulerBand *band = data;
+
+    crw_ruler_layout_clear(&band->layout);
+}
+
+guint crw_ruler_add_band(CrwRuler *self, CrwRulerScale scale, double unit)
+{
+    g_return_val_if_fail(unit > 0, G_MAXUINT);
+
+    if (self->bands == NULL)
+    {
+        self->bands = g_array_new(FALSE, FALSE, sizeof(CrwRulerBand));
+        g_array_set_clear_func(self->bands, crw_ruler_band_clear);
+    }
+
+    CrwRulerBand band;
+    band.scale = scale;
+    band.unit = unit;
+    crw_ruler_layout_init(&band.layout);
+    g_array_append_val(self->bands, band);
+
+    // Only lay out the new band, with the same inputs as the other bands. Its interval is selected
+    // when its ticks are placed. The layouts of the other bands do not depend on the thickness
+    // of the bands, so they only need to be drawn again.
+    CrwRulerBand *added = &g_array_index(self->bands, CrwRulerBand, self->bands->len - 1);
+    crw_ruler_prepare_band_layout(self, &added->layout, scale, unit, self->layout.size);
+    crw_ruler_place_ticks(&added->layout);
+
+    // The ruler grows across its orientation to give the new band the desired size
+    gtk_widget_queue_resize(GTK_WIDGET(self));
+    crw_ruler_invalidate(self, RULER_DIRTY_GEOMETRY);
+    crw_ruler_layout_changed(self);
+
+    return self->bands->len;
+}
+
+void crw_ruler_clear_bands(CrwRuler *self)
+{
+    if (self->bands == NULL)
+    {
+        return;
+    }
+
+    g_clear_pointer(&self->bands, g_array_unref);
+    gtk_widget_queue_resize(GTK_WIDGET(self));
+    crw_ruler_invalidate(self, RULER_DIRTY_GEOMETRY);
+    crw_ruler_layout_changed(self);
+}
+
+guint crw_ruler_get_n_bands(CrwRuler *self)
+{
+    return self->bands != NULL ? self->bands->len + 1 : 1;
+}
+
 static void crw_ruler_set_property(GObject *object,
                                    guint property_id,
                                    const GValue *value,
@@ -263,6 +814,14 @@ static void crw_ruler_set_property(GObject *object,
             crw_ruler_set_min_major_tick_spacing(self, g_value_get_int(value));
             break;
 
+        case PROP_SCALE:
+            crw_ruler_set_scale(self, g_value_get_enum(value));
+            break;
+
+        case PROP_FRAME_RATE:
+            crw_ruler_set_frame_rate(self, g_value_get_int(value));
+            break;
+
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
             break;
@@ -290,6 +849,14 @@ static void crw_ruler_get_property(GObject *object,
             g_value_set_enum(value, crw_ruler_get_orientation(self));
             break;
 
+        case PROP_SCALE:
+            g_value_set_enum(value, crw_ruler_get_scale(self));
+            break;
+
+        case PROP_FRAME_RATE:
+            g_value_set_int(value, crw_ruler_get_frame_rate(self));
+            break;
+
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
             break;
@@ -309,18 +876,6 @@ const double LABEL_ALIGN = 0.65;
 const double TEXT_ANCHOR = 0.5;
 
 
-int crw_ruler_range_to_draw_pos(double lower_limit, double upper_limit, double pos, double allocated_size)
-{
-    double range_size = upper_limit - lower_limit;
-    double scale = allocated_size / range_size;
-    return (int)round(scale * (pos - lower_limit));
-}
-
-void crw_ruler_draw_outline(CrwRuler *self, cairo_t *cr)
-{
-    self->draw_outline(self, cr);
-}
-
 void crw_ruler_draw_outline_horizontal(CrwRuler *self, cairo_t *cr)
 {
     int width = gtk_widget_get_width(GTK_WIDGET(self));
@@ -369,17 +924,23 @@ void crw_ruler_draw_outline_vertical(CrwRuler *self, cairo_t *cr)
     cairo_stroke(cr);
 }
 
-void crw_ruler_draw_tick(CrwRuler *self, cairo_t *cr, double pos, double tick_length_percent, bool draw_label, const char* label)
+void crw_ruler_draw_outline(CrwRuler *self, cairo_t *cr)
 {
-    return self->draw_tick(self, cr, pos, tick_length_percent, draw_label, label);
+    if (self->orientation == GTK_ORIENTATION_HORIZONTAL)
+    {
+        crw_ruler_draw_outline_horizontal(self, cr);
+    }
+    else
+    {
+        crw_ruler_draw_outline_vertical(self, cr);
+    }
 }
 
-void crw_ruler_draw_tick_horizontal(CrwRuler *self, cairo_t *cr, double pos, double tick_length_percent, bool draw_label, const char* label)
+void crw_ruler_draw_tick_horizontal(CrwRuler *self, cairo_t *cr, int draw_pos, int band_size, double tick_length_percent, bool draw_label, const char* label)
 {
-    int width = gtk_widget_get_width(GTK_WIDGET(self));
-    int height = gtk_widget_get_height(GTK_WIDGET(self));
+    // Ticks are drawn upwards from the bottom of their band
+    int height = band_size;
 
-    int draw_pos = crw_ruler_range_to_draw_pos(self->lower_limit, self->upper_limit, pos, width);
     double tick_length = round(height * tick_length_percent);
 
     const double DRAW_OFFSET = cairo_get_line_width(cr) * LINE_COORD_OFFSET;
@@ -401,12 +962,11 @@ void crw_ruler_draw_tick_horizontal(CrwRuler *self, cairo_t *cr, double pos, dou
     }
 }
 
-void crw_ruler_draw_tick_vertical(CrwRuler *self, cairo_t *cr, double pos, double tick_length_percent, bool draw_label, const char* label)
+void crw_ruler_draw_tick_vertical(CrwRuler *self, cairo_t *cr, int draw_pos, int band_size, double tick_length_percent, bool draw_label, const char* label)
 {
-    int width = gtk_widget_get_width(GTK_WIDGET(self));
-    int height = gtk_widget_get_height(GTK_WIDGET(self));
+    // Ticks are drawn leftwards from the right side of their band
+    int width = band_size;
 
-    int draw_pos = crw_ruler_range_to_draw_pos(self->lower_limit, self->upper_limit, pos, height);
     double tick_length = round(width * tick_length_percent);
 
     const double DRAW_OFFSET = cairo_get_line_width(cr) * LINE_COORD_OFFSET;
@@ -434,174 +994,722 @@ void crw_ruler_draw_tick_vertical(CrwRuler *self, cairo_t *cr, double pos, doubl
     }
 }
 
-int crw_ruler_range_pixel_spacing(CrwRuler *self, double lower_pos, double upper_pos)
+void crw_ruler_draw_tick(CrwRuler *self, cairo_t *cr, int draw_pos, int band_size, double tick_length_percent, bool draw_label, const char* label)
 {
-    return self->pixel_spacing(self, lower_pos, upper_pos);
+    if (self->orientation == GTK_ORIENTATION_HORIZONTAL)
+    {
+        crw_ruler_draw_tick_horizontal(self, cr, draw_pos, band_size, tick_length_percent, draw_label, label);
+    }
+    else
+    {
+        crw_ruler_draw_tick_vertical(self, cr, draw_pos, band_size, tick_length_percent, draw_label, label);
+    }
 }
 
-int crw_ruler_pixel_spacing_horizontal(CrwRuler *self, double lower_pos, double upper_pos)
+/**
+ * Draws the density band along the edge of the ruler from which the ticks are drawn.
+ * @param self
+ * @param cr Cairo context to draw to.
+ */
+static void crw_ruler_draw_density(CrwRuler *self, cairo_t *cr)
 {
+    if (self->density == NULL)
+    {
+        return;
+    }
+
     int width = gtk_widget_get_width(GTK_WIDGET(self));
+    int height = gtk_widget_get_height(GTK_WIDGET(self));
+    bool horizontal = self->orientation == GTK_ORIENTATION_HORIZONTAL;
 
-    int lower_pixel_pos = crw_ruler_range_to_draw_pos(self->lower_limit, self->upper_limit, lower_pos, width);
-    int upper_pixel_pos = crw_ruler_range_to_draw_pos(self->lower_limit, self->upper_limit, upper_pos, width);
+    int n_pixels = horizontal ? width : height;
+    if (n_pixels <= 0)
+    {
+        return;
+    }
+
+    if (n_pixels > self->n_density_samples)
+    {
+        self->density_samples = g_renew(CrwDensityBucket, self->density_samples, n_pixels);
+        self->n_density_samples = n_pixels;
+    }
 
-    return upper_pixel_pos - lower_pixel_pos;
+    // Read a single level of the pyramid, with one bucket per pixel
+    uint64_t max_count = crw_density_pyramid_sample(self->density,
+                                                    self->lower_limit,
+                                                    self->upper_limit,
+                                                    n_pixels,
+                                                    self->density_samples);
+    if (max_count == 0)
+    {
+        return;
+    }
+
+    const GdkRGBA *color = &self->style.color;
+    double log_max_count = log1p((double) max_count);
+
+    cairo_save(cr);
+    for (int pixel = 0; pixel < n_pixels; pixel++)
+    {
+        uint64_t count = self->density_samples[pixel].count;
+        if (count == 0)
+        {
+            continue;
+        }
+
+        // Use a logarithmic scale, so sparse regions remain visible next to dense regions
+        double intensity = log1p((double) count) / log_max_count;
+        cairo_set_source_rgba(cr, color->red, color->green, color->blue, color->alpha * intensity);
+
+        if (horizontal)
+        {
+            cairo_rectangle(cr, pixel, height - ruler_density_band_size, 1, ruler_density_band_size);
+        }
+        else
+        {
+            cairo_rectangle(cr, width - ruler_density_band_size, pixel, ruler_density_band_size, 1);
+        }
+        cairo_fill(cr);
+    }
+    cairo_restore(cr);
 }
 
-int crw_ruler_pixel_spacing_vertical(CrwRuler *self, double lower_pos, double upper_pos)
+/**
+ * Replaces the density pyramid of a ruler.
+ * @param self
+ * @param density The new density pyramid, of which the ruler takes ownership. May be NULL.
+ */
+static void crw_ruler_set_density(CrwRuler *self, CrwDensityPyramid *density)
 {
-    int height = gtk_widget_get_height(GTK_WIDGET(self));
+    crw_density_pyramid_free(self->density);
+    self->density = density;
+
+    crw_ruler_invalidate(self, RULER_DIRTY_GEOMETRY);
+}
+
+void crw_ruler_set_density_values(CrwRuler *self, const double *values, gsize n_values)
+{
+    g_return_if_fail(values != NULL);
+    g_return_if_fail(n_values > 0);
 
-    int lower_pixel_pos = crw_ruler_range_to_draw_pos(self->lower_limit, self->upper_limit, lower_pos, height);
-    int upper_pixel_pos = crw_ruler_range_to_draw_pos(self->lower_limit, self->upper_limit, upper_pos, height);
+    CrwDensityPyramid *density = crw_density_pyramid_new(values, n_values, CRW_DENSITY_PYRAMID_DEFAULT_LEAF_BITS);
+    if (density == NULL)
+    {
+        g_critical("Could not build the density pyramid of a ruler; are the first and last value finite?");
+        return;
+    }
+
+    crw_ruler_set_density(self, density);
+}
+
+gboolean crw_ruler_set_density_file(CrwRuler *self, const char *filename, GError **error)
+{
+    g_return_val_if_fail(filename != NULL, FALSE);
+
+    GMappedFile *file = g_mapped_file_new(filename, FALSE, error);
+    if (file == NULL)
+    {
+        return FALSE;
+    }
+
+    gsize length = g_mapped_file_get_length(file);
+    if (length == 0 || length % sizeof(double) != 0)
+    {
+        g_set_error(error, G_FILE_ERROR, G_FILE_ERROR_INVAL,
+                    "File “%s” does not contain an array of doubles", filename);
+        g_mapped_file_unref(file);
+        return FALSE;
+    }
+
+    // Build the pyramid straight from the mapped pages, without copying the values to the heap
+    const double *values = (const double *) g_mapped_file_get_contents(file);
+    CrwDensityPyramid *density = crw_density_pyramid_new(values,
+                                                         length / sizeof(double),
+                                                         CRW_DENSITY_PYRAMID_DEFAULT_LEAF_BITS);
+    g_mapped_file_unref(file);
+
+    if (density == NULL)
+    {
+        g_set_error(error, G_FILE_ERROR, G_FILE_ERROR_INVAL,
+                    "Could not build the density pyramid for “%s”; are the first and last value finite?",
+                    filename);
+        return FALSE;
+    }
+
+    crw_ruler_set_density(self, density);
+    return TRUE;
+}
 
-    return upper_pixel_pos - lower_pixel_pos;
+void crw_ruler_clear_density(CrwRuler *self)
+{
+    crw_ruler_set_density(self, NULL);
 }
 
 /**
- * Draws the minor ticks for a given range.
+ * Draws the ticks of all bands of a ruler in a single pass, stacking the bands
+ * away from the edge from which the ticks are drawn.
  * @param self
  * @param cr Cairo context to draw to.
- * @param lower The lower limit of the range.
- * @param upper The upper limit of the range.
- * @param depth The depth of the recursion.
- * @param tick_length_percent The length of the ticks to draw.
  */
-static void crw_ruler_draw_minor_ticks(CrwRuler *self,
-                                       cairo_t *cr,
-                                       double lower,
-                                       double upper,
-                                       int depth,
-                                       double tick_length_percent)
+static void crw_ruler_draw_ticks(CrwRuler *self, cairo_t *cr)
 {
-    if (depth > ruler_max_tick_depth - 1)
+    int width = gtk_widget_get_width(GTK_WIDGET(self));
+    int height = gtk_widget_get_height(GTK_WIDGET(self));
+    bool horizontal = self->orientation == GTK_ORIENTATION_HORIZONTAL;
+
+    guint n_bands = crw_ruler_get_n_bands(self);
+    int band_size = (horizontal ? height : width) / (int) n_bands;
+    const double DRAW_OFFSET = cairo_get_line_width(cr) * LINE_COORD_OFFSET;
+
+    for (guint band = 0; band < n_bands; band++)
+    {
+        const CrwRulerLayout *layout = band == 0
+                ? &self->layout
+                : &g_array_index(self->bands, CrwRulerBand, band - 1).layout;
+
+        // Move the edge of the band to the edge of the ruler
+        cairo_save(cr);
+        if (horizontal)
+        {
+            cairo_translate(cr, 0, height - (int) (band + 1) * band_size);
+        }
+        else
+        {
+            cairo_translate(cr, width - (int) (band + 1) * band_size, 0);
+        }
+
+        for (size_t i = 0; i < layout->n_ticks; i++)
+        {
+            const CrwRulerTick *tick = &layout->ticks[i];
+
+            // Every level of subdivision halves the length of the ticks
+            double tick_length_percent = ldexp(self->major_tick_length_percent, -tick->level);
+            crw_ruler_draw_tick(self, cr, tick->pos, band_size, tick_length_percent, tick->level == 0, tick->label);
+        }
+
+        // Separate the band from the band below it
+        if (band > 0)
+        {
+            if (horizontal)
+            {
+                cairo_move_to(cr, 0, band_size - DRAW_OFFSET);
+                cairo_line_to(cr, width, band_size - DRAW_OFFSET);
+            }
+            else
+            {
+                cairo_move_to(cr, band_size - DRAW_OFFSET, 0);
+                cairo_line_to(cr, band_size - DRAW_OFFSET, height);
+            }
+            cairo_stroke(cr);
+        }
+        cairo_restore(cr);
+    }
+}
+
+// ============================
+// ===== LAYOUT FUNCTIONS =====
+
+/**
+ * Copies the inputs for the layout of a single band of a ruler.
+ * @param self
+ * @param layout The layout of the band.
+ * @param scale The scale of the band.
+ * @param unit The size of a unit of the band in units of the range of the ruler.
+ * @param size The size in pixels of the ruler along its orientation.
+ */
+static void crw_ruler_prepare_band_layout(CrwRuler *self,
+                                          CrwRulerLayout *layout,
+                                          CrwRulerScale scale,
+                                          double unit,
+                                          int size)
+{
+    layout->lower_limit = self->lower_limit / unit;
+    layout->upper_limit = self->upper_limit / unit;
+    layout->size = size;
+    layout->min_major_tick_spacing = self->min_major_tick_spacing;
+    layout->scale = scale;
+    layout->frame_rate = self->frame_rate;
+}
+
+/**
+ * Copies the inputs for the layouts of all bands of a ruler from the widget. Must be called on the main thread.
+ * @param self
+ */
+static void crw_ruler_prepare_layout(CrwRuler *self)
+{
+    int size;
+    if (self->orientation == GTK_ORIENTATION_HORIZONTAL)
+    {
+        size = gtk_widget_get_width(GTK_WIDGET(self));
+    }
+    else
+    {
+        size = gtk_widget_get_height(GTK_WIDGET(self));
+    }
+
+    crw_ruler_prepare_band_layout(self, &self->layout, self->scale, 1, size);
+
+    for (guint i = 0; self->bands != NULL && i < self->bands->len; i++)
+    {
+        CrwRulerBand *band = &g_array_index(self->bands, CrwRulerBand, i);
+        crw_ruler_prepare_band_layout(self, &band->layout, band->scale, band->unit, size);
+    }
+
+    self->layout_select_interval = (self->dirty & RULER_DIRTY_SELECT_INTERVAL) != 0;
+}
+
+/**
+ * Places the ticks of a prepared layout, reporting when its tick storage could not be allocated.
+ * @param layout
+ */
+static void crw_ruler_place_ticks(CrwRulerLayout *layout)
+{
+    if (!crw_ruler_layout_place_ticks(layout))
+    {
+        g_critical("Could not allocate the ticks of a ruler layout");
+    }
+}
+
+/**
+ * Selects the interval of a prepared layout if it is outdated, and places its ticks.
+ * @param layout
+ * @param select_interval Whether the interval is outdated.
+ */
+static void crw_ruler_run_band_layout(CrwRulerLayout *layout, bool select_interval)
+{
+    if (select_interval)
+    {
+        crw_ruler_layout_select_interval(layout);
+    }
+    crw_ruler_place_ticks(layout);
+}
+
+/**
+ * Selects the intervals and places the ticks of the prepared layouts of all bands of a ruler.
+ * \remark Only accesses the prepared state of the ruler, so it is safe to call from a worker thread
+ * while the main thread waits for it.
+ * @param self
+ */
+static void crw_ruler_run_layout(CrwRuler *self)
+{
+    bool select_interval = self->layout_select_interval;
+
+    crw_ruler_run_band_layout(&self->layout, select_interval);
+
+    for (guint i = 0; self->bands != NULL && i < self->bands->len; i++)
+    {
+        crw_ruler_run_band_layout(&g_array_index(self->bands, CrwRulerBand, i).layout, select_interval);
+    }
+}
+
+/**
+ * Computes the layouts of a single ruler of a batch. Runs on a thread of the shared worker pool.
+ * @param data The \c CrwRuler of which to compute the layouts.
+ * @param user_data Unused.
+ */
+static void crw_ruler_layout_worker(gpointer data, gpointer user_data)
+{
+    crw_ruler_run_layout(data);
+
+    g_mutex_lock(&ruler_batch_mutex);
+    ruler_batch_remaining--;
+    if (ruler_batch_remaining == 0)
+    {
+        g_cond_signal(&ruler_batch_cond);
+    }
+    g_mutex_unlock(&ruler_batch_mutex);
+}
+
+/**
+ * Hands the layouts of all pending rulers to the shared worker pool
+ * and waits until all of them have been computed.
+ */
+static void crw_ruler_flush_pending_layouts(void)
+{
+    guint n_pending = ruler_pending_layouts->len;
+    if (n_pending == 0)
     {
         return;
     }
 
-    // Check that there is enough space between minor tick and edges of the limit when drawn
-    if (crw_ruler_range_pixel_spacing(self, lower, upper) < ruler_min_minor_tick_spacing)
+    g_mutex_lock(&ruler_batch_mutex);
+    ruler_batch_remaining = n_pending;
+    g_mutex_unlock(&ruler_batch_mutex);
+
+    for (guint i = 0; i < n_pending; i++)
+    {
+        CrwRuler *ruler = g_ptr_array_index(ruler_pending_layouts, i);
+        crw_ruler_prepare_layout(ruler);
+        ruler->layout_pending = false;
+
+        // The other rulers of the batch still need to be drawn with their new layout
+        ruler->dirty = (ruler->dirty & ~RULER_DIRTY_LAYOUT) | RULER_DIRTY_GEOMETRY;
+        ruler->layout_changed = true;
+
+        g_thread_pool_push(ruler_layout_pool, ruler, NULL);
+    }
+    g_ptr_array_set_size(ruler_pending_layouts, 0);
+
+    // Join the batch before anything gets drawn
+    g_mutex_lock(&ruler_batch_mutex);
+    while (ruler_batch_remaining > 0)
+    {
+        g_cond_wait(&ruler_batch_cond, &ruler_batch_mutex);
+    }
+    g_mutex_unlock(&ruler_batch_mutex);
+}
+
+/**
+ * Marks parts of a ruler as outdated and queues the ruler for a redraw.
+ * @param self
+ * @param dirty The \c CrwRulerDirty bits of the outdated parts.
+ */
+static void crw_ruler_invalidate(CrwRuler *self, guint dirty)
+{
+    if ((dirty & RULER_DIRTY_LAYOUT) && ruler_parallel_layout && !self->layout_pending)
+    {
+        g_ptr_array_add(ruler_pending_layouts, self);
+        self->layout_pending = true;
+    }
+
+    // Several changes before the next frame only queue a single redraw
+    if (self->dirty == 0)
+    {
+        gtk_widget_queue_draw(GTK_WIDGET(self));
+    }
+    self->dirty |= dirty;
+
+    if ((dirty & RULER_DIRTY_LAYOUT)
+        && g_signal_has_handler_pending(self, signals[SIGNAL_LAYOUT_CHANGED], 0, TRUE))
+    {
+        crw_ruler_request_layout_changed(self);
+    }
+}
+
+/**
+ * Computes the layouts of a ruler if they are outdated, leaving the ruler to be drawn again.
+ * Must be called on the main thread.
+ * @param self
+ */
+static void crw_ruler_resolve_layout(CrwRuler *self)
+{
+    if (!(self->dirty & RULER_DIRTY_LAYOUT))
     {
         return;
     }
 
-    // Draw tick in middle of range
-    double tick_pos = lower + (upper - lower) / 2;
-    crw_ruler_draw_tick(self, cr, tick_pos, tick_length_percent, false, NULL);
+    if (self->layout_pending)
+    {
+        // Compute the layouts of all rulers invalidated since the last batch at once
+        crw_ruler_flush_pending_layouts();
+    }
+    else
+    {
+        crw_ruler_prepare_layout(self);
+        crw_ruler_run_layout(self);
 
-    // Recursively draw minor ticks between lower limit, tick position and upper limit
-    crw_ruler_draw_minor_ticks(self, cr, lower, tick_pos, depth + 1, 0.5 * tick_length_percent);
-    crw_ruler_draw_minor_ticks(self, cr, tick_pos, upper, depth + 1, 0.5 * tick_length_percent);
+        self->dirty = (self->dirty & ~RULER_DIRTY_LAYOUT) | RULER_DIRTY_GEOMETRY;
+        self->layout_changed = true;
+    }
 }
 
-static void crw_ruler_draw_ticks(CrwRuler *self, cairo_t *cr)
+/**
+ * Brings all outdated parts of a ruler up-to-date before it is drawn.
+ * @param self
+ * @return True if the contents of the ruler have changed and need to be drawn again.
+ */
+static bool crw_ruler_resolve(CrwRuler *self)
 {
-    int first_tick = crw_ruler_first_tick(self->lower_limit, self->interval);
+    guint dirty = self->dirty;
+    if (dirty == 0)
+    {
+        return false;
+    }
 
-    int pos = first_tick;
-    // Move pos over the ruler range
-    while (pos < self->upper_limit)
+    if (dirty & RULER_DIRTY_STYLE)
     {
-        char *str_format = "%d";
-        int buffer_size = snprintf(NULL, 0, str_format, pos);
-        char *label_str = malloc(buffer_size + 1);
-        snprintf(label_str, buffer_size + 1, str_format, pos);
+        crw_ruler_resolve_style(self);
+    }
+
+    crw_ruler_resolve_layout(self);
+
+    self->dirty = 0;
+    return true;
+}
+
+const CrwRulerTick *crw_ruler_get_ticks(CrwRuler *self, guint band, gsize *n_ticks)
+{
+    g_return_val_if_fail(band < crw_ruler_get_n_bands(self), NULL);
+    g_return_val_if_fail(n_ticks != NULL, NULL);
+
+    crw_ruler_resolve_layout(self);
 
-        crw_ruler_draw_tick(self, cr, pos, self->major_tick_length_percent, true, label_str);
-        free(label_str);
+    const CrwRulerLayout *layout = band == 0
+            ? &self->layout
+            : &g_array_index(self->bands, CrwRulerBand, band - 1).layout;
 
-        // Draw minor ticks between major ticks
-        crw_ruler_draw_minor_ticks(self, cr, pos, pos + self->interval, 0, 0.5 * self->major_tick_length_percent);
+    *n_ticks = layout->n_ticks;
+    return layout->ticks;
+}
+
+void crw_ruler_set_parallel_layout(gboolean enabled)
+{
+    if (ruler_parallel_layout == (bool) enabled)
+    {
+        return;
+    }
 
-        pos += self->interval;
+    if (ruler_pending_layouts == NULL)
+    {
+        ruler_pending_layouts = g_ptr_array_new();
+    }
+
+    if (enabled && ruler_layout_pool == NULL)
+    {
+        ruler_layout_pool = g_thread_pool_new(crw_ruler_layout_worker,
+                                              NULL,
+                                              (gint) g_get_num_processors(),
+                                              FALSE,
+                                              NULL);
     }
+
+    if (!enabled)
+    {
+        // Pending rulers keep their dirty bits and will be laid out on their own when drawn
+        for (guint i = 0; i < ruler_pending_layouts->len; i++)
+        {
+            CrwRuler *ruler = g_ptr_array_index(ruler_pending_layouts, i);
+            ruler->layout_pending = false;
+        }
+        g_ptr_array_set_size(ruler_pending_layouts, 0);
+    }
+
+    ruler_parallel_layout = enabled;
 }
 
-static void crw_ruler_switch_draw_strategy(CrwRuler *self, GtkOrientation orientation)
+gboolean crw_ruler_get_parallel_layout(void)
 {
-    if (orientation == GTK_ORIENTATION_HORIZONTAL)
+    return ruler_parallel_layout;
+}
+
+// =================================
+// ===== LAYOUT-CHANGED SIGNAL =====
+
+/**
+ * Requests the layout phase of the next frame again, after the emission of
+ * \c CrwRuler::layout-changed has been deferred. Called in the update phase of that frame.
+ * @return \c G_SOURCE_REMOVE
+ */
+static gboolean crw_ruler_layout_changed_tick(GtkWidget *widget, GdkFrameClock *frame_clock, gpointer user_data)
+{
+    CRW_RULER(widget)->layout_changed_deferred = false;
+    gdk_frame_clock_request_phase(frame_clock, GDK_FRAME_CLOCK_PHASE_LAYOUT);
+    return G_SOURCE_REMOVE;
+}
+
+/**
+ * Emits \c CrwRuler::layout-changed if the layout of a ruler has changed. Called in the layout phase
+ * of the frame clock, after the widgets have been allocated, so the layout is computed with the size
+ * that the ruler will be drawn with.
+ * @param frame_clock
+ * @param user_data The ruler.
+ */
+static void crw_ruler_frame_clock_layout(GdkFrameClock *frame_clock, gpointer user_data)
+{
+    CrwRuler *self = CRW_RULER(user_data);
+
+    // Stop following the layout phase once nothing is connected to the signal anymore
+    if (!g_signal_has_handler_pending(self, signals[SIGNAL_LAYOUT_CHANGED], 0, TRUE))
     {
-        self->draw_outline = crw_ruler_draw_outline_horizontal;
-        self->draw_tick = crw_ruler_draw_tick_horizontal;
-        self->pixel_spacing = crw_ruler_pixel_spacing_horizontal;
+        g_clear_signal_handler(&self->frame_clock_layout_handler, frame_clock);
+        return;
     }
-    else
+
+    crw_ruler_resolve_layout(self);
+    if (!self->layout_changed)
     {
-        self->draw_outline = crw_ruler_draw_outline_vertical;
-        self->draw_tick = crw_ruler_draw_tick_vertical;
-        self->pixel_spacing = crw_ruler_pixel_spacing_vertical;
+        return;
     }
+
+    // The layout phase can run more than once per frame, but the signal is emitted at most once
+    gint64 frame = gdk_frame_clock_get_frame_counter(frame_clock);
+    if (frame == self->layout_changed_frame)
+    {
+        if (!self->layout_changed_deferred)
+        {
+            gtk_widget_add_tick_callback(GTK_WIDGET(self), crw_ruler_layout_changed_tick, NULL, NULL);
+            self->layout_changed_deferred = true;
+        }
+        return;
+    }
+
+    self->layout_changed = false;
+    self->layout_changed_frame = frame;
+    g_signal_emit(self, signals[SIGNAL_LAYOUT_CHANGED], 0);
 }
 
 /**
- * Updates the interval using the current range and allocated size
- * and queues the ruler for a redraw.
+ * Makes sure \c CrwRuler::layout-changed is emitted in the next frame of a ruler.
  * @param self
  */
-static void crw_ruler_update_interval(CrwRuler *self)
+static void crw_ruler_request_layout_changed(CrwRuler *self)
 {
-    GtkOrientation orientation = gtk_orientable_get_orientation(GTK_ORIENTABLE(self));
-    int ruler_size;
-    if (orientation == GTK_ORIENTATION_HORIZONTAL)
+    GdkFrameClock *frame_clock = gtk_widget_get_frame_clock(GTK_WIDGET(self));
+    if (frame_clock == NULL)
     {
-        ruler_size = gtk_widget_get_width(GTK_WIDGET(self));
+        // Requested again when the ruler is realized
+        return;
     }
-    else
+
+    // Only rulers of which the layout is followed connect to the layout phase of the frame clock.
+    // The root allocates its widgets in its own handler of the layout phase, which it connects
+    // whenever a resize is pending, so connect after it to see the new allocation.
+    if (self->frame_clock_layout_handler == 0)
     {
-        ruler_size = gtk_widget_get_height(GTK_WIDGET(self));
+        self->frame_clock_layout_handler = g_signal_connect_after(frame_clock,
+                                                                  "layout",
+                                                                  G_CALLBACK(crw_ruler_frame_clock_layout),
+                                                                  self);
     }
+    gdk_frame_clock_request_phase(frame_clock, GDK_FRAME_CLOCK_PHASE_LAYOUT);
+}
+
+/**
+ * Marks the layout of a ruler as changed without computing it again, such as when a band is added,
+ * and makes sure \c CrwRuler::layout-changed is emitted if anything is connected to it.
+ * @param self
+ */
+static void crw_ruler_layout_changed(CrwRuler *self)
+{
+    self->layout_changed = true;
+
+    if (g_signal_has_handler_pending(self, signals[SIGNAL_LAYOUT_CHANGED], 0, TRUE))
+    {
+        crw_ruler_request_layout_changed(self);
+    }
+}
+
+// ===========================
+// ===== STYLE FUNCTIONS =====
+
+/**
+ * Returns the font size in pixels of a font description.
+ * @param font The font description.
+ * @param resolution The resolution in dots per inch used to convert font sizes in points.
+ * @return The font size in pixels, or 0 if the font description has no size.
+ */
+static double crw_ruler_font_size_pixels(const PangoFontDescription *font, double resolution)
+{
+    double size = (double) pango_font_description_get_size(font) / PANGO_SCALE;
 
-    if (ruler_size > 0)
+    if (pango_font_description_get_size_is_absolute(font))
     {
-        self->interval = crw_ruler_calculate_interval(
-                ruler_size,
-                self->min_major_tick_spacing,
-                self->upper_limit - self->lower_limit);
+        return size;
     }
 
-    // Queue the ruler to be redrawn now that the interval has possibly changed
-    gtk_widget_queue_draw(GTK_WIDGET(self));
+    // The size is expressed in points, of which there are 72 in an inch
+    return size * resolution / 72;
 }
 
 /**
- * Calculates the largest interval between major ruler ticks such that the pixel spacing between
- * the major ticks is at least \p min_size_segment.
- * \remark The calculation is generic for both vertical and horizontal rulers, but is framed as for
- * a horizontal ruler.
- * @param ruler_width The allocated width for the ruler. Must be larger than 0.
- * @param min_size_segment The minimum space in pixels between major ruler ticks.
- * @param range_size The total size of the range. Must be larger than 0.
- * @return An appropriate interval.
+ * Resolves the color, padding and font of a ruler from its CSS node and caches them.
+ * @param self
  */
-static int crw_ruler_calculate_interval(int ruler_width, int min_size_segment, double range_size)
+static void crw_ruler_resolve_style(CrwRuler *self)
 {
-    g_return_val_if_fail(ruler_width > 0, 1);
-    g_return_val_if_fail(min_size_segment > 0, 1);
-    g_return_val_if_fail(range_size > 0, 1);
+    GtkWidget *widget = GTK_WIDGET(self);
+    GtkStyleContext *context = gtk_widget_get_style_context(widget);
+    CrwRulerStyle *style = &self->style;
+
+    gtk_style_context_get_padding(context, &style->padding);
+    gtk_style_context_get_color(context, &style->color);
+
+    // The pango context of a widget follows the font properties of its CSS node
+    PangoContext *pango_context = gtk_widget_get_pango_context(widget);
+    const PangoFontDescription *font = pango_context_get_font_description(pango_context);
+
+    double resolution = pango_cairo_context_get_resolution(pango_context);
+    if (resolution <= 0)
+    {
+        resolution = 96;
+    }
 
-    double max_num_segments = fmax(1, floor((double)ruler_width/min_size_segment));
-    double smallest_interval = ceil(range_size / max_num_segments);
-    double interval_magnitude = fmax(0, ceil(log10(smallest_interval)) - 1);
+    style->font_size = crw_ruler_font_size_pixels(font, resolution);
+    if (style->font_size <= 0)
+    {
+        style->font_size = ruler_default_font_size;
+    }
 
-    int interval = 1;
-    int n_valid_intervals = sizeof(ruler_valid_intervals) / sizeof(ruler_valid_intervals[0]);
-    for (int i = 0; i < n_valid_intervals && interval < smallest_interval; i++)
+    // Cairo's toy font API takes a single family, so only use the first of a list of families
+    char family[RULER_FONT_FAMILY_SIZE];
+    const char *families = pango_font_description_get_family(font);
+    if (families == NULL || families[0] == '\0')
     {
-        interval = (int)(ruler_valid_intervals[i] * pow(10, interval_magnitude));
+        families = ruler_default_font_family;
     }
-    return interval;
+    size_t family_length = MIN(strcspn(families, ","), sizeof(family) - 1);
+    memcpy(family, families, family_length);
+    family[family_length] = '\0';
+
+    // Cairo's toy font API only distinguishes between normal and bold fonts
+    cairo_font_weight_t weight = pango_font_description_get_weight(font) >= PANGO_WEIGHT_SEMIBOLD
+            ? CAIRO_FONT_WEIGHT_BOLD
+            : CAIRO_FONT_WEIGHT_NORMAL;
+
+    cairo_font_slant_t slant;
+    switch (pango_font_description_get_style(font))
+    {
+        case PANGO_STYLE_ITALIC:
+            slant = CAIRO_FONT_SLANT_ITALIC;
+            break;
+
+        case PANGO_STYLE_OBLIQUE:
+            slant = CAIRO_FONT_SLANT_OBLIQUE;
+            break;
+
+        default:
+            slant = CAIRO_FONT_SLANT_NORMAL;
+            break;
+    }
+
+    g_clear_pointer(&style->font_face, cairo_font_face_destroy);
+    style->font_face = cairo_toy_font_face_create(family, slant, weight);
 }
 
+
 /**
- * Returns a number x such that x is a multiple of \p interval and is smaller than \p range_lower.
- * @param range_lower The lower limit of the range.
- * @param interval The interval of the ruler.
- * @return A number x such that x is a multiple of \p interval and is smaller than \p range_lower.
+ * Draws the contents of a ruler.
+ * @param self
+ * @param cr Cairo context to draw to.
  */
-static int crw_ruler_first_tick(double range_lower, int interval)
+static void crw_ruler_draw(CrwRuler *self, cairo_t *cr)
 {
-    return (int)floor(range_lower / interval) * interval;
+    GtkWidget *widget = GTK_WIDGET(self);
+    GtkStyleContext *context = gtk_widget_get_style_context(widget);
+
+    GtkAllocation *allocation = &((GtkAllocation) {0, 0, 0, 0});
+    gtk_widget_get_allocation(widget, allocation);
+    const GtkBorder *padding = &self->style.padding;
+
+    // Render the background according to the style context
+    gtk_render_background(context, cr,
+                          padding->left,
+                          padding->right,
+                          allocation->width,
+                          allocation->height);
+
+    // Setup cairo context
+    cairo_set_line_width(cr, 1);
+    gdk_cairo_set_source_rgba(cr, &self->style.color);
+    cairo_set_antialias(cr, CAIRO_ANTIALIAS_NONE);
+    cairo_set_line_cap(cr, CAIRO_LINE_CAP_SQUARE);
+
+    cairo_set_font_face(cr, self->style.font_face);
+    cairo_set_font_size(cr, self->style.font_size);
+
+    crw_ruler_draw_density(self, cr);
+    crw_ruler_draw_outline(self, cr);
+    crw_ruler_draw_ticks(self, cr);
 }
 
 
@@ -628,11 +1736,25 @@ static void crw_ruler_measure(GtkWidget *widget,
     {
         *natural_size = self->desired_height;
     }
+
+    // The desired size across the ruler is the size of each band, so stacked bands do not overlap
+    if (orientation != self->orientation)
+    {
+        *natural_size *= (int) crw_ruler_get_n_bands(self);
+    }
 }
 
 static void crw_ruler_size_allocate(GtkWidget *widget, int width, int height, int baseline)
 {
-    crw_ruler_update_interval(CRW_RULER(widget));
+    CrwRuler *self = CRW_RULER(widget);
+
+    // A change across the orientation of the ruler only requires drawing again,
+    // which the snapshot notices from the bounds of its render node
+    int size = self->orientation == GTK_ORIENTATION_HORIZONTAL ? width : height;
+    if (size != self->layout.size)
+    {
+        crw_ruler_invalidate(self, RULER_DIRTY_ALLOCATION);
+    }
 
     // Call parent class size_allocate
     GTK_WIDGET_CLASS(crw_ruler_parent_class)->size_allocate(widget, width, height, baseline);
@@ -642,54 +1764,126 @@ static void crw_ruler_snapshot(GtkWidget *widget, GtkSnapshot *snapshot)
 {
     CrwRuler* self = CRW_RULER(widget);
 
-    // Create a draw strategy object if we haven't already
-    crw_ruler_switch_draw_strategy(self, self->orientation);
-
-    GtkStyleContext *context = gtk_widget_get_style_context(widget);
-
-    GtkAllocation *allocation = &((GtkAllocation) {0, 0, 0, 0});
-    gtk_widget_get_allocation(widget, allocation);
-    GtkBorder *padding = &((GtkBorder) {0, 0, 0, 0});
-    gtk_style_context_get_padding(context, padding);
+    bool content_changed = crw_ruler_resolve(self);
 
     int width = gtk_widget_get_width(widget);
     int height = gtk_widget_get_height(widget);
 
-    // Create a cairo context that we can use to draw to
-    cairo_t *cr = gtk_snapshot_append_cairo(snapshot, &GRAPHENE_RECT_INIT(0, 0, width, height));
+    if (width <= 0 || height <= 0)
+    {
+        return;
+    }
 
-    // Render the background according to the style context
-    gtk_render_background(context, cr,
-                          padding->left,
-                          padding->right,
-                          allocation->width,
-                          allocation->height);
+    graphene_rect_t bounds = GRAPHENE_RECT_INIT(0, 0, width, height);
 
-    // Retrieve the foreground color from the style context
-    GdkRGBA color = {0, 0, 0, 1};
-    gtk_style_context_get_color(context, &color);
+    // Only draw again when the contents or the size have changed, otherwise append the last render node
+    graphene_rect_t node_bounds;
+    if (self->node != NULL)
+    {
+        gsk_render_node_get_bounds(self->node, &node_bounds);
+    }
+    if (self->node == NULL || content_changed || !graphene_rect_equal(&node_bounds, &bounds))
+    {
+        // The cairo node records the drawing and is rasterized by the renderer at the scale
+        // of the output, so it stays sharp under fractional scaling
+        g_clear_pointer(&self->node, gsk_render_node_unref);
+        self->node = gsk_cairo_node_new(&bounds);
+
+        cairo_t *cr = gsk_cairo_node_get_draw_context(self->node);
+        crw_ruler_draw(self, cr);
+        cairo_destroy(cr);
+    }
 
-    // Setup cairo context
-    cairo_set_line_width(cr, 1);
-    gdk_cairo_set_source_rgba(cr, &color);
-    cairo_set_antialias(cr, CAIRO_ANTIALIAS_NONE);
-    cairo_set_line_cap(cr, CAIRO_LINE_CAP_SQUARE);
+    gtk_snapshot_append_node(snapshot, self->node);
+}
 
-    cairo_select_font_face(cr, FONT_FAMILY, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
-    cairo_set_font_size(cr, FONT_SIZE);
+static void crw_ruler_css_changed(GtkWidget *widget, GtkCssStyleChange *change)
+{
+    CrwRuler *self = CRW_RULER(widget);
 
-    crw_ruler_draw_outline(self, cr);
-    crw_ruler_draw_ticks(self, cr);
+    // Call base css_changed function
+    GTK_WIDGET_CLASS(crw_ruler_parent_class)->css_changed(widget, change);
 
-    cairo_destroy(cr);
+    // Resolve the style again the next time the ruler is drawn
+    crw_ruler_invalidate(self, RULER_DIRTY_STYLE);
+}
+
+static void crw_ruler_realize(GtkWidget *widget)
+{
+    CrwRuler *self = CRW_RULER(widget);
+
+    // Call base realize function
+    GTK_WIDGET_CLASS(crw_ruler_parent_class)->realize(widget);
+
+    // Only rulers to which a range has been published follow the update phase of the frame clock
+    if (g_atomic_pointer_get(&self->publication) != NULL)
+    {
+        self->frame_clock_update_handler = g_signal_connect(gtk_widget_get_frame_clock(widget),
+                                                            "update",
+                                                            G_CALLBACK(crw_ruler_frame_clock_update),
+                                                            self);
+    }
+
+    if (g_signal_has_handler_pending(self, signals[SIGNAL_LAYOUT_CHANGED], 0, TRUE))
+    {
+        self->layout_changed = true;
+        crw_ruler_request_layout_changed(self);
+    }
 }
 
 static void crw_ruler_unrealize(GtkWidget *widget)
 {
+    CrwRuler *self = CRW_RULER(widget);
+
+    g_clear_signal_handler(&self->frame_clock_update_handler, gtk_widget_get_frame_clock(widget));
+    g_clear_signal_handler(&self->frame_clock_layout_handler, gtk_widget_get_frame_clock(widget));
+
+    // Tick callbacks are removed along with the frame clock, so a deferred emission is requested
+    // again when the ruler is realized
+    self->layout_changed_deferred = false;
+
     // Call base unrealize function
     GTK_WIDGET_CLASS(crw_ruler_parent_class)->unrealize(widget);
 }
 
+static void crw_ruler_unmap(GtkWidget *widget)
+{
+    CrwRuler *self = CRW_RULER(widget);
+
+    // Call base unmap function
+    GTK_WIDGET_CLASS(crw_ruler_parent_class)->unmap(widget);
+
+    // Hidden rulers, such as those in rows scrolled out of a list, do not keep their drawing
+    g_clear_pointer(&self->node, gsk_render_node_unref);
+}
+
+static void crw_ruler_finalize(GObject *object)
+{
+    CrwRuler *self = CRW_RULER(object);
+
+    if (self->layout_pending)
+    {
+        g_ptr_array_remove_fast(ruler_pending_layouts, self);
+    }
+    crw_ruler_layout_clear(&self->layout);
+    g_clear_pointer(&self->bands, g_array_unref);
+    crw_density_pyramid_free(self->density);
+    g_free(self->density_samples);
+
+    if (self->publication != NULL)
+    {
+        g_source_destroy(self->publication->source);
+        g_source_unref(self->publication->source);
+        g_free(self->publication);
+    }
+
+    g_clear_pointer(&self->node, gsk_render_node_unref);
+    g_clear_pointer(&self->style.font_face, cairo_font_face_destroy);
+
+    // Call base finalize function
+    G_OBJECT_CLASS(crw_ruler_parent_class)->finalize(object);
+}
+
 // ================================
 // ===== CLASS INITIALIZATION =====
 
@@ -701,12 +1895,16 @@ static void crw_ruler_class_init(CrwRulerClass *klass)
     // Assign getter and setter function for properties
     object_class->set_property = crw_ruler_set_property;
     object_class->get_property = crw_ruler_get_property;
+    object_class->finalize = crw_ruler_finalize;
 
     // Override virtual functions in parent
     widget_class->measure = crw_ruler_measure;
     widget_class->size_allocate = crw_ruler_size_allocate;
     widget_class->snapshot = crw_ruler_snapshot;
+    widget_class->css_changed = crw_ruler_css_changed;
+    widget_class->realize = crw_ruler_realize;
     widget_class->unrealize = crw_ruler_unrealize;
+    widget_class->unmap = crw_ruler_unmap;
 
     props[PROP_DESIRED_WIDTH] =
             g_param_spec_int("desired-width",
@@ -736,6 +1934,35 @@ static void crw_ruler_class_init(CrwRulerClass *klass)
                              1, G_MAXINT, default_min_major_tick_spacing,
                              G_PARAM_WRITABLE|G_PARAM_EXPLICIT_NOTIFY|G_PARAM_CONSTRUCT);
 
+    props[PROP_SCALE] =
+            g_param_spec_enum("scale",
+                              "Scale",
+                              "The scale with which the range of the ruler is labelled.",
+                              CRW_TYPE_RULER_SCALE, CRW_RULER_SCALE_LINEAR,
+                              G_PARAM_READWRITE|G_PARAM_EXPLICIT_NOTIFY);
+
+    props[PROP_FRAME_RATE] =
+            g_param_spec_int("frame-rate",
+                             "Frame rate",
+                             "The number of frames per second of a timecode scale.",
+                             1, G_MAXINT, ruler_default_frame_rate,
+                             G_PARAM_READWRITE|G_PARAM_EXPLICIT_NOTIFY|G_PARAM_CONSTRUCT);
+
+    /**
+     * CrwRuler::layout-changed:
+     *
+     * Emitted at most once per frame, in the layout phase of the frame clock, when the ticks
+     * of the ruler have been computed again. Use \c crw_ruler_get_ticks() to read the new ticks.
+     */
+    signals[SIGNAL_LAYOUT_CHANGED] =
+            g_signal_new("layout-changed",
+                         G_TYPE_FROM_CLASS(klass),
+                         G_SIGNAL_RUN_LAST,
+                         0,
+                         NULL, NULL,
+                         NULL,
+                         G_TYPE_NONE, 0);
+
     // Override orientation property of GtkOrientable
     g_object_class_override_property(object_class, PROP_ORIENTATION, "orientation");
 
@@ -751,7 +1978,9 @@ static void crw_ruler_init(CrwRuler *self)
     self->upper_limit = 10;
     self->tick_width = 1;
 
-    crw_ruler_switch_draw_strategy(self, self->orientation);
+    crw_ruler_layout_init(&self->layout);
+    self->dirty = RULER_DIRTY_ALL;
+    self->layout_changed_frame = -1;
 }
 
 GtkWidget *crw_ruler_new(GtkOrientation orientation)
@@ -2,8 +2,13 @@
 
 #include <gtk/gtk.h>
 
+#include "crw-ruler-core.h"
+
 G_BEGIN_DECLS
 
+#define CRW_TYPE_RULER_SCALE crw_ruler_scale_get_type()
+GType crw_ruler_scale_get_type(void);
+
 #define CRW_TYPE_RULER crw_ruler_get_type()
 G_DECLARE_FINAL_TYPE(CrwRuler, crw_ruler, CRW, RULER, GtkWidget)
 
@@ -12,6 +17,25 @@ struct _CrwRulerClass
     GtkWidgetClass parent_class;
 };
 
+/**
+ * The range and properties of a ruler that can be applied at once with \c crw_ruler_rebind().
+ */
+typedef struct
+{
+    /** The lower limit of the range. Must be finite and smaller than \c upper_limit. */
+    double lower_limit;
+    /** The upper limit of the range. Must be finite and greater than \c lower_limit. */
+    double upper_limit;
+    /** The length of the major ticks, as a fraction of the height or width of the ruler, from 0.1 to 1. */
+    double major_tick_length;
+    /** The minimum spacing in pixels between major ruler ticks. Must be larger than 0. */
+    int min_major_tick_spacing;
+    /** The scale with which the range is labelled. */
+    CrwRulerScale scale;
+    /** The number of frames per second of a timecode scale. Must be larger than 0. */
+    int frame_rate;
+} CrwRulerConfig;
+
 /**
  * Creates a new ruler.
  * @param orientation The orientation of the ruler.
@@ -22,11 +46,27 @@ GtkWidget *crw_ruler_new(GtkOrientation orientation);
 /**
  * Sets the range that the ruler will display.
  * @param ruler
- * @param lower_limit The lower limit of the range. Must be smaller than \p upper_limit.
- * @param upper_limit The upper limit of the range. Must be greater than \p lower_limit.
+ * @param lower_limit The lower limit of the range. Must be finite and smaller than \p upper_limit.
+ * @param upper_limit The upper limit of the range. Must be finite and greater than \p lower_limit.
  */
 void crw_ruler_set_range(CrwRuler *ruler, double lower_limit, double upper_limit);
 
+/**
+ * Publishes the range that a ruler will display from any thread.
+ *
+ * \remark The range is written to a double buffer guarded by a single-writer sequence lock,
+ * from which the ruler reads it in the update phase of its next frame. Publishing never waits,
+ * for the main thread or otherwise. The main loop is only woken up when the range differs
+ * from the previously published range, and only once until that frame. Apart from the first
+ * range published to a ruler, publishing a range does not allocate memory. Ranges must be
+ * published to a ruler from a single thread at a time, such as the render thread of a viewport.
+ * The ruler must not be finalized while a range is being published.
+ * @param self
+ * @param lower_limit The lower limit of the range. Must be finite and smaller than \p upper_limit.
+ * @param upper_limit The upper limit of the range. Must be finite and greater than \p lower_limit.
+ */
+void crw_ruler_publish_range_threadsafe(CrwRuler *self, double lower_limit, double upper_limit);
+
 /**
  * Returns the lower limit of the range of a ruler.
  * @param self
@@ -45,7 +85,8 @@ double crw_ruler_get_upper_limit(CrwRuler *self);
  * Sets the desired width of a ruler.
  *
  * \remark When the ruler is not set to expand horizontally using \c Gtk.Widget:hexpand,
- * the ruler will attempt to maintain the given width.
+ * the ruler will attempt to maintain the given width. For a vertical ruler, this is the width of each band,
+ * so a ruler with stacked bands requests the width times the number of bands.
  * @param self
  * @param width The desired width.
  */
@@ -55,7 +96,8 @@ void crw_ruler_set_desired_width(CrwRuler *self, int width);
  * Sets the desired height of a ruler.
  *
  * \remark When the ruler is not set to expand vertically using \c Gtk.Widget:vexpand,
- * the ruler will attempt to maintain the given height.
+ * the ruler will attempt to maintain the given height. For a horizontal ruler, this is the height of each band,
+ * so a ruler with stacked bands requests the height times the number of bands.
  * @param self
  * @param height The desired height.
  */
@@ -76,4 +118,149 @@ void crw_ruler_set_major_tick_length(CrwRuler *self, double length_percent);
  */
 void crw_ruler_set_min_major_tick_spacing(CrwRuler *self, int min_spacing);
 
+/**
+ * Sets the scale with which a ruler labels its range.
+ *
+ * \remark With \c CRW_RULER_SCALE_TIMECODE, the range is expressed in seconds.
+ * With \c CRW_RULER_SCALE_CALENDAR, the range is expressed in nanoseconds since the Unix epoch.
+ * @param self
+ * @param scale The scale of the ruler.
+ */
+void crw_ruler_set_scale(CrwRuler *self, CrwRulerScale scale);
+
+/**
+ * Returns the scale with which a ruler labels its range.
+ * @param self
+ * @return The scale of the ruler.
+ */
+CrwRulerScale crw_ruler_get_scale(CrwRuler *self);
+
+/**
+ * Sets the number of frames per second of a ruler with a timecode scale.
+ *
+ * \remark Drop-frame timecode is not supported. Fractional NTSC rates should use the nominal
+ * integer rate, such as 30 for 29.97 frames per second.
+ * @param self
+ * @param frame_rate The number of frames per second. Must be larger than 0.
+ */
+void crw_ruler_set_frame_rate(CrwRuler *self, int frame_rate);
+
+/**
+ * Returns the number of frames per second of a ruler with a timecode scale.
+ * @param self
+ * @return The number of frames per second.
+ */
+int crw_ruler_get_frame_rate(CrwRuler *self);
+
+/**
+ * Returns the range and properties of a ruler.
+ *
+ * \remark Use this to fill in the fields that \c crw_ruler_rebind() should leave unchanged.
+ * @param self
+ * @param config Return location for the range and properties.
+ */
+void crw_ruler_get_config(CrwRuler *self, CrwRulerConfig *config);
+
+/**
+ * Applies a range and properties to a ruler at once.
+ *
+ * \remark Intended for rulers that are recycled, such as the rulers in the rows of a \c GtkListView.
+ * Only the parts of the ruler affected by the changed values are invalidated, with a single redraw,
+ * and the storage of the tick layout is kept. The density band and the additional bands of the ruler
+ * are left unchanged.
+ * @param self
+ * @param config The range and properties to apply.
+ */
+void crw_ruler_rebind(CrwRuler *self, const CrwRulerConfig *config);
+
+/**
+ * Stacks an additional band of ticks on a ruler, sharing the range and allocation of the ruler.
+ *
+ * \remark The ruler itself is the first band, closest to the edge from which the ticks are drawn.
+ * Additional bands are stacked away from that edge, and all bands are drawn in a single pass.
+ * The bands share the size of the ruler across its orientation equally, and the ruler requests
+ * its desired size across its orientation for each band.
+ * For example, a ruler of which the range is expressed in millimeters can show centimeters and
+ * inches with units of 10 and 25.4, and a ruler with a timecode scale can show seconds with a
+ * linear band and a unit of 1.
+ * @param self
+ * @param scale The scale with which the band labels the range.
+ * @param unit The size of a unit of the band in units of the range of the ruler. Must be larger than 0.
+ * @return The index of the band, or \c G_MAXUINT if \p unit is invalid.
+ */
+guint crw_ruler_add_band(CrwRuler *self, CrwRulerScale scale, double unit);
+
+/**
+ * Removes all additional bands of a ruler.
+ * @param self
+ */
+void crw_ruler_clear_bands(CrwRuler *self);
+
+/**
+ * Returns the number of bands of a ruler, including the ruler itself.
+ * @param self
+ * @return The number of bands.
+ */
+guint crw_ruler_get_n_bands(CrwRuler *self);
+
+/**
+ * Returns the ticks of a band of a ruler, computing them first if they are outdated.
+ *
+ * \remark The positions of the ticks are in pixels along the orientation of the ruler, relative
+ * to its allocation, so a canvas sharing the allocation can draw gridlines that match the ticks.
+ * The ticks are owned by the ruler and remain valid until its layout changes, which is signalled
+ * with \c CrwRuler::layout-changed.
+ * @param self
+ * @param band The index of the band, where the ruler itself is band 0.
+ * @param n_ticks Return location for the number of ticks.
+ * @return The ticks, ordered by major tick with its minor ticks following it.
+ */
+const CrwRulerTick *crw_ruler_get_ticks(CrwRuler *self, guint band, gsize *n_ticks);
+
+/**
+ * Shows a density band of where the values of an array lie along the range of a ruler.
+ *
+ * \remark The values are aggregated once into a min/max/count pyramid, after which the
+ * array is no longer needed. Drawing the band reads one bucket per pixel, regardless of
+ * the number of values.
+ * @param self
+ * @param values The values in ascending order.
+ * @param n_values The number of values. Must be larger than 0.
+ */
+void crw_ruler_set_density_values(CrwRuler *self, const double *values, gsize n_values);
+
+/**
+ * Shows a density band of where the values in a file lie along the range of a ruler.
+ *
+ * \remark The file is memory-mapped while it is aggregated into a min/max/count pyramid
+ * in a single pass, so the values are never copied to the heap.
+ * @param self
+ * @param filename The file, containing an array of doubles in native byte order and ascending order.
+ * @param error Return location for an error.
+ * @return True if the density band has been set.
+ */
+gboolean crw_ruler_set_density_file(CrwRuler *self, const char *filename, GError **error);
+
+/**
+ * Removes the density band of a ruler.
+ * @param self
+ */
+void crw_ruler_clear_density(CrwRuler *self);
+
+/**
+ * Enables or disables parallel layout for all rulers.
+ *
+ * \remark When enabled, the layouts of all rulers that have been invalidated since the last frame
+ * are computed in a single batch by a shared pool of worker threads when the first of them is drawn.
+ * This is only worthwhile for applications that show a large number of rulers at once.
+ * @param enabled Whether to compute the layouts of rulers in parallel.
+ */
+void crw_ruler_set_parallel_layout(gboolean enabled);
+
+/**
+ * Returns whether the layouts of rulers are computed in parallel.
+ * @return True if parallel layout is enabled.
+ */
+gboolean crw_ruler_get_parallel_layout(void);
+
 G_END_DECLS
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <crw-density-pyramid.h>
+
+/** The number of checks that failed. */
+static int n_failures = 0;
+
+/**
+ * Checks a condition and reports where it failed, without stopping the test.
+ */
+#define TEST_CHECK(condition) test_check((condition), #condition, __LINE__)
+
+static void test_check(int passed, const char *condition, int line)
+{
+    if (!passed)
+    {
+        fprintf(stderr, "test-density-pyramid.c:%d: check failed: %s\n", line, condition);
+        n_failures++;
+    }
+}
+
+// ===========================
+// ===== TEST FUNCTIONS =====
+
+static void test_sample(void)
+{
+    // The values 0 to 15, one in each of the 16 leaves
+    double values[16];
+    for (int i = 0; i < 16; i++)
+    {
+        values[i] = i;
+    }
+
+    CrwDensityPyramid *pyramid = crw_density_pyramid_new(values, 16, 4);
+    TEST_CHECK(pyramid != NULL);
+    TEST_CHECK(crw_density_pyramid_get_count(pyramid) == 16);
+
+    CrwDensityBucket buckets[16];
+
+    // A pixel per leaf reads the finest level
+    TEST_CHECK(crw_density_pyramid_sample(pyramid, 0, 15, 16, buckets) == 1);
+    for (int i = 0; i < 16; i++)
+    {
+        TEST_CHECK(buckets[i].count == 1 && buckets[i].min == i && buckets[i].max == i);
+    }
+
+    // Two pixels read the level below the root
+    TEST_CHECK(crw_density_pyramid_sample(pyramid, 0, 15, 2, buckets) == 8);
+    TEST_CHECK(buckets[0].count == 8 && buckets[0].min == 0 && buckets[0].max == 7);
+    TEST_CHECK(buckets[1].count == 8 && buckets[1].min == 8 && buckets[1].max == 15);
+
+    // A single pixel reads the root
+    TEST_CHECK(crw_density_pyramid_sample(pyramid, 0, 15, 1, buckets) == 16);
+    TEST_CHECK(buckets[0].min == 0 && buckets[0].max == 15);
+
+    // Pixels outside the values are empty
+    TEST_CHECK(crw_density_pyramid_sample(pyramid, -100, -50, 4, buckets) == 0);
+    TEST_CHECK(buckets[0].count == 0 && buckets[3].count == 0);
+    TEST_CHECK(crw_density_pyramid_sample(pyramid, -15, 15, 2, buckets) == 16);
+    TEST_CHECK(buckets[0].count == 0 && buckets[1].count == 16);
+
+    // Invalid ranges sample nothing
+    TEST_CHECK(crw_density_pyramid_sample(pyramid, 15, 0, 2, buckets) == 0);
+    TEST_CHECK(crw_density_pyramid_sample(pyramid, NAN, 15, 2, buckets) == 0);
+
+    crw_density_pyramid_free(pyramid);
+}
+
+static void test_non_finite(void)
+{
+    // NaN values in between are skipped
+    double with_nan[] = {0, NAN, 1, 2};
+    CrwDensityPyramid *pyramid = crw_density_pyramid_new(with_nan, 4, 2);
+    TEST_CHECK(pyramid != NULL);
+    TEST_CHECK(crw_density_pyramid_get_count(pyramid) == 3);
+    crw_density_pyramid_free(pyramid);
+
+    // The range spanned by the values must be finite
+    double infinite[] = {-INFINITY, 0};
+    TEST_CHECK(crw_density_pyramid_new(infinite, 2, 2) == NULL);
+    double nan_last[] = {0, NAN};
+    TEST_CHECK(crw_density_pyramid_new(nan_last, 2, 2) == NULL);
+
+    // Extreme but finite ranges do not overflow the size of the leaves
+    double extreme[] = {-1e308, 1e308};
+    pyramid = crw_density_pyramid_new(extreme, 2, 2);
+    TEST_CHECK(pyramid != NULL);
+    TEST_CHECK(crw_density_pyramid_get_count(pyramid) == 2);
+    crw_density_pyramid_free(pyramid);
+}
+
+int main(void)
+{
+    test_sample();
+    test_non_finite();
+
+    if (n_failures > 0)
+    {
+        fprintf(stderr, "%d checks failed\n", n_failures);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,246 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <crw-ruler-core.h>
+
+/** The number of checks that failed. */
+static int n_failures = 0;
+
+/**
+ * Checks a condition and reports where it failed, without stopping the test.
+ */
+#define TEST_CHECK(condition) test_check((condition), #condition, __LINE__)
+
+static void test_check(int passed, const char *condition, int line)
+{
+    if (!passed)
+    {
+        fprintf(stderr, "test-layout.c:%d: check failed: %s\n", line, condition);
+        n_failures++;
+    }
+}
+
+// ===========================
+// ===== TEST FUNCTIONS =====
+
+/**
+ * Computes a layout of a range on an 800 pixels wide ruler.
+ * @param layout The layout, which is initialized by the caller.
+ * @param scale
+ * @param lower_limit
+ * @param upper_limit
+ * @param min_major_tick_spacing
+ */
+static void test_compute(CrwRulerLayout *layout,
+                         CrwRulerScale scale,
+                         double lower_limit,
+                         double upper_limit,
+                         int min_major_tick_spacing)
+{
+    layout->lower_limit = lower_limit;
+    layout->upper_limit = upper_limit;
+    layout->size = 800;
+    layout->min_major_tick_spacing = min_major_tick_spacing;
+    layout->scale = scale;
+    TEST_CHECK(crw_ruler_layout_compute(layout));
+}
+
+/**
+ * Returns the major tick of a layout with a given index.
+ * @param layout
+ * @param index The index among the major ticks only.
+ * @return The tick, or NULL if the layout has fewer major ticks.
+ */
+static const CrwRulerTick *test_major_tick(const CrwRulerLayout *layout, size_t index)
+{
+    for (size_t i = 0; i < layout->n_ticks; i++)
+    {
+        if (layout->ticks[i].level == 0 && index-- == 0)
+        {
+            return &layout->ticks[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Returns the number of major ticks of a layout.
+ * @param layout
+ */
+static size_t test_n_major_ticks(const CrwRulerLayout *layout)
+{
+    size_t n_major_ticks = 0;
+    for (size_t i = 0; i < layout->n_ticks; i++)
+    {
+        n_major_ticks += layout->ticks[i].level == 0;
+    }
+    return n_major_ticks;
+}
+
+/**
+ * Checks the labels of consecutive major ticks of a layout.
+ * @param layout
+ * @param first The index among the major ticks of the first label to check.
+ * @param labels The expected labels, terminated by NULL.
+ * @param line The line of the caller, for reporting.
+ */
+static void test_check_labels(const CrwRulerLayout *layout, size_t first, const char *const *labels, int line)
+{
+    for (size_t i = 0; labels[i] != NULL; i++)
+    {
+        const CrwRulerTick *tick = test_major_tick(layout, first + i);
+        if (tick == NULL || strcmp(tick->label, labels[i]) != 0)
+        {
+            fprintf(stderr, "test-layout.c:%d: major tick %zu is \"%s\", expected \"%s\"\n",
+                    line, first + i, tick != NULL ? tick->label : "(none)", labels[i]);
+            n_failures++;
+        }
+    }
+}
+
+#define TEST_CHECK_LABELS(layout, first, ...) \
+    test_check_labels((layout), (first), (const char *const[]) {__VA_ARGS__, NULL}, __LINE__)
+
+// ===== LINEAR SCALE =====
+
+static void test_linear(void)
+{
+    CrwRulerLayout layout;
+    crw_ruler_layout_init(&layout);
+
+    // 16 segments of at least 50 pixels need an interval of at least 100 / 16
+    test_compute(&layout, CRW_RULER_SCALE_LINEAR, 0, 100, 50);
+    TEST_CHECK(layout.interval == 10);
+    TEST_CHECK(test_n_major_ticks(&layout) == 10);
+    TEST_CHECK_LABELS(&layout, 0, "0", "10", "20");
+    TEST_CHECK(test_major_tick(&layout, 5)->pos == 400);
+
+    // Panning keeps the interval and starts at the multiple of the interval below the range
+    layout.lower_limit = 5;
+    layout.upper_limit = 105;
+    TEST_CHECK(crw_ruler_layout_place_ticks(&layout));
+    TEST_CHECK(layout.interval == 10);
+    TEST_CHECK_LABELS(&layout, 0, "0", "10");
+    TEST_CHECK(test_major_tick(&layout, 0)->pos == -40);
+
+    test_compute(&layout, CRW_RULER_SCALE_LINEAR, -37.5, 1234, 50);
+    TEST_CHECK(layout.interval == 100);
+    TEST_CHECK_LABELS(&layout, 0, "-100", "0", "100");
+
+    // Intervals beyond the range of int
+    test_compute(&layout, CRW_RULER_SCALE_LINEAR, 0, 1e12, 50);
+    TEST_CHECK(layout.interval == 100000000000);
+    TEST_CHECK(test_n_major_ticks(&layout) == 10);
+    TEST_CHECK_LABELS(&layout, 0, "0", "100000000000");
+
+    // Ranges beyond 2^62 have no ticks
+    test_compute(&layout, CRW_RULER_SCALE_LINEAR, 0, 1e300, 50);
+    TEST_CHECK(layout.interval == 0);
+    TEST_CHECK(layout.n_ticks == 0);
+
+    crw_ruler_layout_clear(&layout);
+}
+
+// ===== TIMECODE SCALE =====
+
+static void test_timecode(void)
+{
+    CrwRulerLayout layout;
+    crw_ruler_layout_init(&layout);
+
+    // A step of 3 frames divides 24 frames per second, so every second is a major tick
+    layout.frame_rate = 24;
+    test_compute(&layout, CRW_RULER_SCALE_TIMECODE, 0, 2, 50);
+    TEST_CHECK(layout.step_unit == CRW_RULER_STEP_FRAMES && layout.step == 3);
+    TEST_CHECK_LABELS(&layout, 0, "00:00:00:00", "00:00:00:03");
+    TEST_CHECK_LABELS(&layout, 7, "00:00:00:21", "00:00:01:00", "00:00:01:03");
+
+    // Negative timecodes step towards zero and never cross it
+    layout.frame_rate = 25;
+    test_compute(&layout, CRW_RULER_SCALE_TIMECODE, -2, 1, 50);
+    TEST_CHECK(layout.step == 5);
+    TEST_CHECK_LABELS(&layout, 0, "-00:00:02:00", "-00:00:01:20", "-00:00:01:15");
+    TEST_CHECK_LABELS(&layout, 9, "-00:00:00:05", "00:00:00:00", "00:00:00:05");
+
+    // Borrowing from the minutes and hours of negative timecodes
+    test_compute(&layout, CRW_RULER_SCALE_TIMECODE, -3601, -3599, 50);
+    TEST_CHECK(layout.step == 5);
+    TEST_CHECK_LABELS(&layout, 0, "-01:00:01:00", "-01:00:00:20");
+    TEST_CHECK_LABELS(&layout, 5, "-01:00:00:00", "-00:59:59:20");
+
+    // Ranges beyond 2^62 frames have no ticks, instead of overflowing the step
+    test_compute(&layout, CRW_RULER_SCALE_TIMECODE, 0, 1e300, 50);
+    TEST_CHECK(layout.step == 0);
+    TEST_CHECK(layout.n_ticks == 0);
+
+    crw_ruler_layout_clear(&layout);
+}
+
+// ===== CALENDAR SCALE =====
+
+#define TEST_NS_PER_HOUR (INT64_C(3600) * 1000000000)
+#define TEST_NS_PER_DAY (24 * TEST_NS_PER_HOUR)
+
+/**
+ * Returns a point in time of a calendar scale.
+ * @param days The number of days since the Unix epoch.
+ * @param hours The hours since the start of the day.
+ * @return The number of nanoseconds since the Unix epoch.
+ */
+static double test_time(int64_t days, int64_t hours)
+{
+    return (double)(days * TEST_NS_PER_DAY + hours * TEST_NS_PER_HOUR);
+}
+
+static void test_calendar(void)
+{
+    CrwRulerLayout layout;
+    crw_ruler_layout_init(&layout);
+
+    // Months carry over into the next year. 2023-11-15 is day 19676 and 2024-04-15 is day 19828.
+    test_compute(&layout, CRW_RULER_SCALE_CALENDAR, test_time(19676, 0), test_time(19828, 0), 100);
+    TEST_CHECK(layout.step_unit == CRW_RULER_STEP_MONTHS && layout.step == 1);
+    TEST_CHECK_LABELS(&layout, 0, "2023-11", "2023-12", "2024-01", "2024-02", "2024-03", "2024-04");
+    // February 2024 is a leap month, so March starts at day 19783
+    TEST_CHECK(test_major_tick(&layout, 4)->value == test_time(19783, 0));
+    TEST_CHECK(test_major_tick(&layout, 4)->value - test_major_tick(&layout, 3)->value == test_time(29, 0));
+
+    // Days step over the leap day. 2024-02-27 is day 19780.
+    test_compute(&layout, CRW_RULER_SCALE_CALENDAR, test_time(19780, 0), test_time(19785, 0), 100);
+    TEST_CHECK(layout.step_unit == CRW_RULER_STEP_NANOSECONDS && layout.step == TEST_NS_PER_DAY);
+    TEST_CHECK_LABELS(&layout, 0, "2024-02-27", "2024-02-28", "2024-02-29", "2024-03-01", "2024-03-02");
+
+    // Hours carry over into the next day and year, which is labelled with its date.
+    // 2023-12-31 is day 19722.
+    test_compute(&layout, CRW_RULER_SCALE_CALENDAR, test_time(19722, 18), test_time(19723, 6), 100);
+    TEST_CHECK(layout.step == 2 * TEST_NS_PER_HOUR);
+    TEST_CHECK_LABELS(&layout, 0, "18:00", "20:00", "22:00", "2024-01-01", "02:00", "04:00");
+
+    // Before the Unix epoch
+    test_compute(&layout, CRW_RULER_SCALE_CALENDAR, test_time(-2, 0), test_time(1, 0), 100);
+    TEST_CHECK(layout.step == 12 * TEST_NS_PER_HOUR);
+    TEST_CHECK_LABELS(&layout, 0, "1969-12-30", "12:00", "1969-12-31", "12:00", "1970-01-01", "12:00");
+
+    // Ranges beyond int64_t nanoseconds have no ticks, instead of overflowing the years
+    test_compute(&layout, CRW_RULER_SCALE_CALENDAR, 0, 1e300, 50);
+    TEST_CHECK(layout.step == 0);
+    TEST_CHECK(layout.n_ticks == 0);
+
+    crw_ruler_layout_clear(&layout);
+}
+
+int main(void)
+{
+    test_linear();
+    test_timecode();
+    test_calendar();
+
+    if (n_failures > 0)
+    {
+        fprintf(stderr, "%d checks failed\n", n_failures);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,217 @@
+#include <errno.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <gtk/gtk.h>
+#include <crw-ruler.h>
+
+/** The number of frames drawn before counting, to fill the caches of the ruler, cairo and GTK. */
+static const int test_warmup_frames = 16;
+
+/** The number of frames of which the allocations are counted. */
+static const int test_counted_frames = 256;
+
+/** The number of snapshots kept alive at once, like GTK keeps the render nodes of the previous frames. */
+#define TEST_N_KEPT_NODES 2
+
+/**
+ * The allocations allowed in a frame in which the contents of the ruler have not changed,
+ * which only appends the last render node of the ruler to the snapshot.
+ */
+static const unsigned long test_unchanged_frame_budget = 2;
+
+/**
+ * The allocations allowed in a frame in which the ruler is panned, which records the drawing
+ * of the ticks and labels in a new cairo node. Placing the ticks reuses the storage of the layout,
+ * so this only grows with the drawing commands recorded by cairo, not with allocations per tick.
+ */
+static const unsigned long test_panned_frame_budget = 512;
+
+// ===================================
+// ===== COUNTING ALLOCATOR =====
+
+// The allocator of glibc, to which the counting allocator forwards
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n_members, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *ptr);
+
+/** Whether the allocations of the current thread are counted. */
+static __thread bool counting = false;
+/** The number of allocations counted since counting started. */
+static __thread unsigned long n_allocations = 0;
+/** The number of frees counted since counting started. */
+static __thread unsigned long n_frees = 0;
+
+static void count_allocation(void)
+{
+    if (counting)
+    {
+        n_allocations++;
+    }
+}
+
+void *malloc(size_t size)
+{
+    count_allocation();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n_members, size_t size)
+{
+    count_allocation();
+    return __libc_calloc(n_members, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    count_allocation();
+    return __libc_realloc(ptr, size);
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+    count_allocation();
+    return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    count_allocation();
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size)
+{
+    count_allocation();
+    void *allocated = __libc_memalign(alignment, size);
+    if (allocated == NULL)
+    {
+        return ENOMEM;
+    }
+    *ptr = allocated;
+    return 0;
+}
+
+void free(void *ptr)
+{
+    if (counting && ptr != NULL)
+    {
+        n_frees++;
+    }
+    __libc_free(ptr);
+}
+
+// ===========================
+// ===== TEST FUNCTIONS =====
+
+/**
+ * Takes an offscreen snapshot of a ruler, optionally panning the ruler first,
+ * and counts the allocations of the ruler while doing so.
+ * @param ruler
+ * @param nodes The render nodes of the previous frames, of which the oldest is released.
+ * @param frame The number of the frame.
+ * @param pan Whether to pan the ruler before the snapshot.
+ * @return The number of allocations.
+ */
+static unsigned long test_frame(GtkWidget *ruler, GskRenderNode **nodes, int frame, bool pan)
+{
+    GtkSnapshot *snapshot = gtk_snapshot_new();
+
+    n_allocations = 0;
+    n_frees = 0;
+    counting = true;
+
+    if (pan)
+    {
+        double offset = frame * 0.37;
+        crw_ruler_set_range(CRW_RULER(ruler), offset, offset + 100);
+    }
+    GTK_WIDGET_GET_CLASS(ruler)->snapshot(ruler, snapshot);
+
+    counting = false;
+
+    // Release the oldest frame, as GTK would after presenting a newer one
+    int slot = frame % TEST_N_KEPT_NODES;
+    g_clear_pointer(&nodes[slot], gsk_render_node_unref);
+    nodes[slot] = gtk_snapshot_free_to_node(snapshot);
+
+    return n_allocations;
+}
+
+/**
+ * Draws a number of frames of a ruler and checks that none of them allocates more than a budget.
+ * @param ruler
+ * @param nodes The render nodes of the previous frames.
+ * @param name The name of the frames, for reporting.
+ * @param pan Whether to pan the ruler in every frame.
+ * @param budget The maximum number of allocations of a frame.
+ * @return True if no frame exceeded the budget.
+ */
+static bool test_frames(GtkWidget *ruler, GskRenderNode **nodes, const char *name, bool pan, unsigned long budget)
+{
+    for (int frame = 0; frame < test_warmup_frames; frame++)
+    {
+        test_frame(ruler, nodes, frame, pan);
+    }
+
+    unsigned long max_allocations = 0;
+    unsigned long total_allocations = 0;
+    int n_over_budget = 0;
+
+    for (int frame = test_warmup_frames; frame < test_warmup_frames + test_counted_frames; frame++)
+    {
+        unsigned long allocations = test_frame(ruler, nodes, frame, pan);
+
+        total_allocations += allocations;
+        max_allocations = MAX(max_allocations, allocations);
+        if (allocations > budget)
+        {
+            n_over_budget++;
+        }
+    }
+
+    g_print("%s frames: %.2f allocations per frame on average, at most %lu, budget %lu\n",
+            name, (double) total_allocations / test_counted_frames, max_allocations, budget);
+
+    if (n_over_budget > 0)
+    {
+        g_printerr("%d of %d %s frames exceeded the budget of %lu allocations\n",
+                   n_over_budget, test_counted_frames, name, budget);
+        return false;
+    }
+    return true;
+}
+
+int main(void)
+{
+    if (!gtk_init_check())
+    {
+        g_printerr("Could not initialize GTK, skipping the test\n");
+        return 77;
+    }
+
+    GtkWidget *ruler = crw_ruler_new(GTK_ORIENTATION_HORIZONTAL);
+    g_object_ref_sink(ruler);
+    crw_ruler_set_range(CRW_RULER(ruler), 0, 100);
+
+    int minimum_size;
+    int natural_size;
+    gtk_widget_measure(ruler, GTK_ORIENTATION_HORIZONTAL, -1, &minimum_size, &natural_size, NULL, NULL);
+    gtk_widget_measure(ruler, GTK_ORIENTATION_VERTICAL, -1, &minimum_size, &natural_size, NULL, NULL);
+    gtk_widget_size_allocate(ruler, &(GtkAllocation) {0, 0, 800, 25}, -1);
+
+    GskRenderNode *nodes[TEST_N_KEPT_NODES] = { NULL, };
+
+    bool passed = test_frames(ruler, nodes, "Unchanged", false, test_unchanged_frame_budget);
+    passed = test_frames(ruler, nodes, "Panned", true, test_panned_frame_budget) && passed;
+
+    for (int i = 0; i < TEST_N_KEPT_NODES; i++)
+    {
+        g_clear_pointer(&nodes[i], gsk_render_node_unref);
+    }
+    g_object_unref(ruler);
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}